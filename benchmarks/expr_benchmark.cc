@@ -0,0 +1,64 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#include <cstddef>
+#include <cstdio>
+
+#include <chrono>
+#include <vector>
+
+#include <lqp/Expr.h>
+
+namespace {
+
+  using Clock = std::chrono::steady_clock;
+
+  double elapsed_ms(Clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  }
+
+  double bench_operator(std::size_t count)
+  {
+    const auto start = Clock::now();
+
+    lqp::LExpr expr;
+
+    for (std::size_t i = 0; i < count; ++i) {
+      expr += static_cast<double>(i % 7 + 1) * lqp::VariableId{ i };
+    }
+
+    return elapsed_ms(start);
+  }
+
+  double bench_accumulation(std::size_t count)
+  {
+    const auto start = Clock::now();
+
+    lqp::LExpr expr;
+    expr.reserve(count);
+
+    for (std::size_t i = 0; i < count; ++i) {
+      expr.add_term(static_cast<double>(i % 7 + 1), lqp::VariableId{ i });
+    }
+
+    expr.finalize();
+
+    return elapsed_ms(start);
+  }
+
+}
+
+int main()
+{
+  const std::vector<std::size_t> sizes = { 1000, 4000, 16000 };
+
+  std::printf("%10s %16s %16s\n", "terms", "operator+= (ms)", "add_term (ms)");
+
+  for (const std::size_t size : sizes) {
+    const double with_operator = bench_operator(size);
+    const double with_accumulation = bench_accumulation(size);
+    std::printf("%10zu %16.3f %16.3f\n", size, with_operator, with_accumulation);
+  }
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#include <cstddef>
+#include <cstdio>
+
+#include <chrono>
+#include <limits>
+#include <vector>
+
+#include <lqp/GlpkSolver.h>
+#include <lqp/Problem.h>
+
+namespace {
+
+  using Clock = std::chrono::steady_clock;
+
+  double elapsed_ms(Clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+  }
+
+  // the optimal solution is the initial basis, so the time of the solve is
+  // mostly the time to load the model in glpk
+  lqp::Problem make_problem(std::size_t variable_count, std::size_t row_count, std::size_t row_length)
+  {
+    lqp::Problem problem;
+    const auto variables = problem.add_variables(variable_count, lqp::VariableCategory::Continuous, lqp::bounds(0.0, 1.0));
+
+    std::vector<std::size_t> row_starts = { 0 };
+    std::vector<std::size_t> col_indices;
+    std::vector<double> values;
+
+    row_starts.reserve(row_count + 1);
+    col_indices.reserve(row_count * row_length);
+    values.reserve(row_count * row_length);
+
+    for (std::size_t row = 0; row < row_count; ++row) {
+      for (std::size_t k = 0; k < row_length; ++k) {
+        // 197 is prime, so the columns of a row are all different
+        col_indices.push_back(variables.first + (row * 37 + k * 197) % variable_count);
+        values.push_back(static_cast<double>((row + k) % 9 + 1));
+      }
+
+      row_starts.push_back(col_indices.size());
+    }
+
+    const std::vector<double> lower(row_count, -std::numeric_limits<double>::infinity());
+    const std::vector<double> upper(row_count, static_cast<double>(row_length));
+    problem.add_rows(row_starts, col_indices, values, lower, upper);
+
+    lqp::LExpr objective;
+    objective.reserve(variable_count);
+
+    for (std::size_t i = 0; i < variable_count; ++i) {
+      objective.add_term(1.0, lqp::VariableId{ variables.first + i });
+    }
+
+    objective.finalize();
+    problem.set_objective(lqp::Sense::Minimize, objective);
+
+    return problem;
+  }
+
+}
+
+int main()
+{
+  struct Size {
+    std::size_t variables;
+    std::size_t rows;
+    std::size_t row_length;
+  };
+
+  // all the models have 1M nonzeros
+  const std::vector<Size> sizes = {
+    { 20000, 10000, 100 },
+    { 100000, 100000, 10 },
+    { 500000, 250000, 4 },
+  };
+
+  lqp::SolverConfig config;
+  config.verbose = false;
+
+  lqp::GlpkSolver solver;
+
+  std::printf("%10s %10s %12s %16s %18s\n", "variables", "rows", "nonzeros", "Problem (ms)", "Compiled (ms)");
+
+  for (const Size& size : sizes) {
+    const lqp::Problem problem = make_problem(size.variables, size.rows, size.row_length);
+
+    auto start = Clock::now();
+    const lqp::Solution solution = solver.solve(problem, config);
+    const double with_problem = elapsed_ms(start);
+
+    const auto compiled = problem.compile();
+
+    start = Clock::now();
+    const lqp::Solution compiled_solution = solver.solve(*compiled, config);
+    const double with_compiled = elapsed_ms(start);
+
+    if (solution.status() != lqp::SolutionStatus::Optimal || compiled_solution.status() != lqp::SolutionStatus::Optimal) {
+      std::fprintf(stderr, "Unexpected status\n");
+      return 1;
+    }
+
+    std::printf("%10zu %10zu %12zu %16.3f %18.3f\n", size.variables, size.rows, compiled->nonzero_count(), with_problem, with_compiled);
+  }
+
+  return 0;
+}
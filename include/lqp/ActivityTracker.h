@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_ACTIVITY_TRACKER_H
+#define LQP_ACTIVITY_TRACKER_H
+
+#include <cstddef>
+
+#include <vector>
+
+#include "Api.h"
+#include "Problem.h"
+#include "Solution.h"
+#include "Variable.h"
+
+namespace lqp {
+
+  // Keeps the activities of the constraints and the value of the objective
+  // of a problem up to date while the values of the variables change one at
+  // a time, for move-based heuristics. A change of a variable costs the
+  // number of terms where the variable appears. The constraints may be
+  // quadratic. The bounds of the variables are not checked. The problem is
+  // borrowed and must outlive the tracker.
+  class LQP_API ActivityTracker {
+  public:
+    // a constraint is violated when its activity is out of its range by
+    // more than the tolerance
+    ActivityTracker(const Problem& problem, const Solution& solution, double tolerance = 1e-6);
+
+    double value(VariableId variable) const;
+    void set_value(VariableId variable, double value);
+    void flip(VariableId variable); // x = 1 - x, for binary variables
+
+    // the change of the objective if the variable had the value, without
+    // changing it
+    double objective_delta(VariableId variable, double value) const;
+
+    // without the constant terms, as in CompiledProblem
+    double activity(ConstraintId constraint) const;
+    bool is_violated(ConstraintId constraint) const;
+
+    // in no particular order
+    const std::vector<std::size_t>& violated_constraints() const;
+    std::size_t violated_constraint_count() const;
+    bool feasible() const;
+
+    double objective_value() const;
+
+    // recomputes the activities and the objective from the values, to
+    // remove the rounding errors accumulated by the updates
+    void refresh();
+
+    Solution solution() const;
+
+  private:
+    static constexpr std::size_t NoVariable = std::size_t(-1);
+    static constexpr std::size_t NotViolated = std::size_t(-1);
+
+    // a term of a constraint or of the objective where the variable
+    // appears, with the other variable of a quadratic term
+    struct Entry {
+      std::size_t row;
+      double coefficient;
+      std::size_t other;
+    };
+
+    double delta(const Entry& entry, std::size_t variable, double change) const;
+    void update_violation(std::size_t row);
+
+    const Problem* m_problem = nullptr;
+    double m_tolerance;
+    std::vector<double> m_values;
+
+    std::vector<std::size_t> m_column_starts;
+    std::vector<Entry> m_entries;
+    std::vector<std::size_t> m_objective_starts;
+    std::vector<Entry> m_objective_entries;
+
+    std::vector<double> m_activities;
+    double m_objective_value = 0.0;
+
+    std::vector<std::size_t> m_violated;
+    std::vector<std::size_t> m_positions; // in m_violated, or NotViolated
+  };
+
+}
+
+#endif // LQP_ACTIVITY_TRACKER_H
@@ -0,0 +1,34 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_ADMM_SOLVER_H
+#define LQP_ADMM_SOLVER_H
+
+#include "Api.h"
+#include "CompiledProblem.h"
+#include "Solver.h"
+
+namespace lqp {
+
+  // Native solver for convex quadratic problems, based on the alternating
+  // direction method of multipliers (ADMM) as in OSQP. The linear systems
+  // are solved with a preconditioned conjugate gradient, so only products
+  // with the sparse quadratic terms and constraints are computed. A
+  // solution is optimal once the residuals of the equilibrated problem are
+  // below 1e-5 and the duality gap is below a relative 1e-5: the
+  // constraints then hold up to about 1e-5 relative to their coefficients
+  // and the objective is within a relative 1e-5 of the optimum. The quadratic
+  // part of the objective must be convex when minimizing (concave when
+  // maximizing). Infeasible and unbounded problems are detected with the
+  // certificates of OSQP, a solve that does not converge has an undefined
+  // status and no values. Only continuous problems are supported and the
+  // output files of the configuration are ignored.
+  class LQP_API AdmmSolver : public Solver {
+  public:
+    bool available() const override;
+    Solution solve(const Problem& problem, const SolverConfig& config) override;
+    Solution solve(const CompiledProblem& problem, const SolverConfig& config = SolverConfig());
+  };
+
+}
+
+#endif // LQP_ADMM_SOLVER_H
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_BATCH_EVALUATOR_H
+#define LQP_BATCH_EVALUATOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <memory>
+#include <vector>
+
+#include "Api.h"
+#include "CompiledProblem.h"
+#include "Problem.h"
+
+namespace lqp {
+
+  // Results of BatchEvaluator::evaluate(), the activity of constraint i for
+  // candidate k is at activities[i * candidate_count + k].
+  struct LQP_API BatchEvaluation {
+    std::size_t candidate_count = 0;
+    std::vector<double> activities;
+    std::vector<double> objectives;
+    std::vector<double> violations; // maximum violation of the bounds of the constraints and variables
+  };
+
+  // Evaluates the objective and the constraints of a compiled problem for
+  // many candidate solutions at once. The candidates form a column-major
+  // matrix with one row per candidate and one column per variable: the
+  // value of variable j for candidate k is at values[j * candidate_count +
+  // k]. The loops run over the candidates, which are contiguous, and the
+  // candidates are processed in blocks that stay in the cache.
+  class LQP_API BatchEvaluator {
+  public:
+    // the candidates have a value for every variable of the compiled
+    // problem, including the auxiliary variables of the linearization; the
+    // problem is borrowed and must outlive the evaluator
+    BatchEvaluator(const CompiledProblem& problem);
+
+    // the candidates have a value for the variables of the problem only,
+    // each auxiliary variable of the linearization gets the value of the
+    // product or of the bit it stands for, so the rows of the quadratic
+    // constraints have their exact activity; the evaluator is not loaded if
+    // the problem can not be linearized
+    BatchEvaluator(const Problem& problem);
+
+    bool loaded() const;
+
+    // values of each candidate
+    std::size_t variable_count() const;
+
+    BatchEvaluation evaluate(const std::vector<double>& values, std::size_t candidate_count) const;
+
+    // the arrays are allocated by the caller, violations may be nullptr
+    void evaluate(const double* values, std::size_t candidate_count, double* activities, double* objectives, double* violations) const;
+
+  private:
+    // definition of an auxiliary variable of the linearization
+    struct Auxiliary {
+      enum Kind : uint8_t {
+        Product, // x_first * x_second
+        Bit,     // bit number second of x_first - lower
+      };
+
+      Kind kind;
+      std::size_t first;
+      std::size_t second;
+      double lower;
+    };
+
+    void evaluate_columns(const double* values, std::size_t candidate_count, double* activities, double* objectives, double* violations) const;
+
+    std::unique_ptr<CompiledProblem> m_compiled; // when built from a problem
+    const CompiledProblem* m_problem = nullptr;
+    std::size_t m_variable_count = 0;
+    std::vector<Auxiliary> m_auxiliaries; // of the variables after m_variable_count
+  };
+
+}
+
+#endif // LQP_BATCH_EVALUATOR_H
@@ -0,0 +1,38 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_BRANCH_AND_BOUND_SOLVER_H
+#define LQP_BRANCH_AND_BOUND_SOLVER_H
+
+#include <cstddef>
+
+#include "Api.h"
+#include "CompiledProblem.h"
+#include "Solver.h"
+
+namespace lqp {
+
+  // Native parallel branch and bound for mixed integer linear problems, on
+  // top of the dual simplex of SimplexSolver. Each thread has its own queue
+  // of nodes: it dives depth first from a node and then continues with the
+  // node of its queue that has the best bound. The idle threads steal the
+  // best nodes of the other queues. The incumbent objective is shared
+  // without locks and the children start from the basis of their parent.
+  // Without use_mip, the relaxation is solved. The branching and
+  // backtracking techniques and the output files of the configuration are
+  // ignored.
+  class LQP_API BranchAndBoundSolver : public Solver {
+  public:
+    // 0 for the hardware concurrency
+    explicit BranchAndBoundSolver(std::size_t thread_count = 0);
+
+    bool available() const override;
+    Solution solve(const Problem& problem, const SolverConfig& config) override;
+    Solution solve(const CompiledProblem& problem, const SolverConfig& config = SolverConfig());
+
+  private:
+    std::size_t m_thread_count = 0;
+  };
+
+}
+
+#endif // LQP_BRANCH_AND_BOUND_SOLVER_H
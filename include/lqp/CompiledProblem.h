@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_COMPILED_PROBLEM_H
+#define LQP_COMPILED_PROBLEM_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Api.h"
+#include "Variable.h"
+
+namespace lqp {
+
+  enum class Sense : uint8_t;
+
+  // Compact row-oriented (CSR) representation of a linear problem, built
+  // by Problem::compile(). The constraint matrix is stored in compressed
+  // sparse rows: the coefficients of row i are at positions
+  // [row_starts()[i], row_starts()[i + 1]) of column_indices() and
+  // values(). Missing bounds are infinite. The constants of the
+  // constraints are folded into their bounds. The quadratic part of the
+  // objective is a list of triplets (i, j, q) with i <= j for q x_i x_j.
+  class LQP_API CompiledProblem {
+  public:
+    std::size_t variable_count() const;
+    std::size_t constraint_count() const;
+    std::size_t nonzero_count() const;
+
+    Sense sense() const;
+    double objective_constant() const;
+    const std::vector<double>& objective() const;
+
+    bool has_quadratic_objective() const;
+    const std::vector<uint32_t>& quadratic_rows() const;
+    const std::vector<uint32_t>& quadratic_columns() const;
+    const std::vector<double>& quadratic_values() const;
+
+    const std::vector<VariableCategory>& variable_categories() const;
+    const std::vector<double>& variable_lower_bounds() const;
+    const std::vector<double>& variable_upper_bounds() const;
+
+    const std::vector<double>& constraint_lower_bounds() const;
+    const std::vector<double>& constraint_upper_bounds() const;
+
+    const std::vector<std::size_t>& row_starts() const;
+    const std::vector<uint32_t>& column_indices() const;
+    const std::vector<double>& values() const;
+
+    std::string_view objective_name() const;
+    std::string_view variable_name(std::size_t index) const;
+    std::string_view constraint_name(std::size_t index) const;
+
+  private:
+    friend class Problem;
+
+    // all the names are stored in a single buffer
+    struct NameTable {
+      std::string buffer;
+      std::vector<std::size_t> offsets = { 0 };
+
+      void add(const std::string& name);
+      std::string_view get(std::size_t index) const;
+    };
+
+    Sense m_sense = {};
+    double m_objective_constant = 0.0;
+    std::vector<double> m_objective;
+    std::vector<uint32_t> m_quadratic_rows;
+    std::vector<uint32_t> m_quadratic_columns;
+    std::vector<double> m_quadratic_values;
+
+    std::vector<VariableCategory> m_variable_categories;
+    std::vector<double> m_variable_lower_bounds;
+    std::vector<double> m_variable_upper_bounds;
+
+    std::vector<double> m_constraint_lower_bounds;
+    std::vector<double> m_constraint_upper_bounds;
+
+    std::vector<std::size_t> m_row_starts = { 0 };
+    std::vector<uint32_t> m_column_indices;
+    std::vector<double> m_values;
+
+    std::string m_objective_name;
+    NameTable m_variable_names;
+    NameTable m_constraint_names;
+  };
+
+}
+
+#endif // LQP_COMPILED_PROBLEM_H
@@ -3,9 +3,15 @@
 #ifndef LQP_EXPR_H
 #define LQP_EXPR_H
 
+#include <cstddef>
+#include <cstdint>
+
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "Api.h"
+#include "TermSpan.h"
 #include "Variable.h"
 
 namespace lqp {
@@ -22,6 +28,12 @@ namespace lqp {
     VariableId variables[2];
   };
 
+  template<typename Impl>
+  class LExprNode;
+
+  template<typename Impl>
+  class QExprNode;
+
   // linear expression
   class LQP_API LExpr {
   public:
@@ -30,12 +42,19 @@ namespace lqp {
     LExpr(VariableId variable);
     LExpr(double coefficient, VariableId variable);
 
+    template<typename Impl>
+    LExpr(const LExprNode<Impl>& node);
+
     bool is_constant() const;
 
     double constant() const;
     double linear_coefficient(VariableId variable) const;
 
-    std::vector<ExprLinearTerm> linear_terms() const;
+    // adds the linear coefficients to a dense array indexed by variable
+    void scatter_linear_coefficients(std::vector<double>& coefficients) const;
+
+    // the terms are sorted by variable once the expression is normalized
+    TermSpan<ExprLinearTerm> linear_terms() const;
 
     LExpr& operator+=(const LExpr& other);
     LExpr& operator-=(const LExpr& other);
@@ -43,99 +62,26 @@ namespace lqp {
     LExpr& operator*=(double factor);
     LExpr& operator/=(double factor);
 
+    // accumulation: add_term() appends a term without normalizing the
+    // expression, finalize() merges all the pending terms at once
+    void reserve(std::size_t count);
+    void add_term(double coefficient, VariableId variable);
+    void finalize();
+
     double evaluate(const Solution& solution) const;
 
   private:
     void normalize();
+    void merge(const LExpr& other, double factor);
 
     friend class QExpr;
 
     double m_constant;
     std::vector<ExprLinearTerm> m_linear_terms;
+    bool m_normalized = true;
   };
 
-  inline LExpr operator-(const LExpr& lhs)
-  {
-    LExpr expr(lhs);
-    expr *= -1.0;
-    return expr;
-  }
-
-  inline LExpr operator+(const LExpr& lhs, const LExpr& rhs)
-  {
-    LExpr expr(lhs);
-    expr += rhs;
-    return expr;
-  }
-
-  inline LExpr operator+(VariableId rhs, VariableId lhs)
-  {
-    return LExpr(rhs) + LExpr(lhs);
-  }
-
-  inline LExpr operator+(double rhs, const LExpr& lhs)
-  {
-    return LExpr(rhs) + lhs;
-  }
-
-  inline LExpr operator+(const LExpr& rhs, double lhs)
-  {
-    return rhs + LExpr(lhs);
-  }
-
-  inline LExpr operator-(const LExpr& lhs, const LExpr& rhs)
-  {
-    LExpr expr(lhs);
-    expr -= rhs;
-    return expr;
-  }
-
-  inline LExpr operator-(VariableId rhs, VariableId lhs)
-  {
-    return LExpr(rhs) - LExpr(lhs);
-  }
-
-  inline LExpr operator-(double rhs, const LExpr& lhs)
-  {
-    return LExpr(rhs) - lhs;
-  }
-
-  inline LExpr operator-(const LExpr& rhs, double lhs)
-  {
-    return rhs - LExpr(lhs);
-  }
-
-  inline LExpr operator*(double lhs, const LExpr& rhs)
-  {
-    LExpr expr(rhs);
-    expr *= lhs;
-    return expr;
-  }
-
-  inline LExpr operator*(const LExpr& lhs, double rhs)
-  {
-    LExpr expr(lhs);
-    expr *= rhs;
-    return expr;
-  }
-
-  inline LExpr operator/(const LExpr& lhs, double rhs)
-  {
-    LExpr expr(lhs);
-    expr /= rhs;
-    return expr;
-  }
-
-  inline LExpr operator*(double lhs, VariableId rhs)
-  {
-    return { lhs, rhs };
-  }
-
-  inline LExpr operator*(VariableId lhs, double rhs)
-  {
-    return { rhs, lhs };
-  }
-
+  // quadratic expression
   class LQP_API QExpr {
   public:
     QExpr();
@@ -146,6 +92,12 @@ namespace lqp {
     QExpr(VariableId variable1, VariableId variable2);
     QExpr(const LExpr& expr1, const LExpr& expr2);
 
+    template<typename Impl>
+    QExpr(const LExprNode<Impl>& node);
+
+    template<typename Impl>
+    QExpr(const QExprNode<Impl>& node);
+
     bool is_constant() const;
     bool is_linear() const;
 
@@ -153,8 +105,10 @@ namespace lqp {
     double linear_coefficient(VariableId variable) const;
     double quadratic_coefficient(VariableId variable1, VariableId variable2) const;
 
-    std::vector<ExprLinearTerm> linear_terms() const;
-    std::vector<ExprQuadraticTerm> quadratic_terms() const;
+    void scatter_linear_coefficients(std::vector<double>& coefficients) const;
+
+    TermSpan<ExprLinearTerm> linear_terms() const;
+    TermSpan<ExprQuadraticTerm> quadratic_terms() const;
 
     QExpr& operator+=(const QExpr& other);
     QExpr& operator-=(const QExpr& other);
@@ -162,69 +116,544 @@ namespace lqp {
     QExpr& operator*=(double factor);
     QExpr& operator/=(double factor);
 
+    // accumulation: see LExpr
+    void reserve(std::size_t linear_count, std::size_t quadratic_count = 0);
+    void add_term(double coefficient, VariableId variable);
+    void add_term(double coefficient, VariableId variable1, VariableId variable2);
+    void finalize();
+
     double evaluate(const Solution& solution) const;
 
   private:
     void normalize();
+    void merge(const QExpr& other, double factor);
 
     double m_constant;
     std::vector<ExprLinearTerm> m_linear_terms;
     std::vector<ExprQuadraticTerm> m_quadratic_terms;
+    bool m_normalized = true;
   };
 
-  inline QExpr operator+(const QExpr& lhs, const QExpr& rhs)
-  {
-    QExpr expr(lhs);
-    expr += rhs;
-    return expr;
+  /*
+   * Expression templates
+   *
+   * The arithmetic operators do not compute anything, they build a lazy
+   * node that records the shape of the expression. The node is evaluated
+   * when it is converted to an LExpr or a QExpr: the terms are counted,
+   * stored in a single buffer and normalized once. Expressions are kept by
+   * reference when they are lvalues, so a node must not outlive them.
+   *
+   * An implementation of a node provides:
+   * - double constant() const
+   * - std::size_t linear_count() const (an upper bound)
+   * - std::size_t quadratic_count() const (an upper bound)
+   * - void for_each_linear(double factor, F& func) const, calls func(coefficient, variable)
+   * - void for_each_quadratic(double factor, F& func) const, calls func(coefficient, variable1, variable2)
+   */
+
+  namespace details {
+
+    struct ConstantImpl {
+      double value;
+
+      double constant() const
+      {
+        return value;
+      }
+
+      std::size_t linear_count() const
+      {
+        return 0;
+      }
+
+      std::size_t quadratic_count() const
+      {
+        return 0;
+      }
+
+      template<typename Func>
+      void for_each_linear([[maybe_unused]] double factor, [[maybe_unused]] Func& func) const
+      {
+      }
+
+      template<typename Func>
+      void for_each_quadratic([[maybe_unused]] double factor, [[maybe_unused]] Func& func) const
+      {
+      }
+    };
+
+    struct VariableImpl {
+      double coefficient;
+      VariableId variable;
+
+      double constant() const
+      {
+        return 0.0;
+      }
+
+      std::size_t linear_count() const
+      {
+        return 1;
+      }
+
+      std::size_t quadratic_count() const
+      {
+        return 0;
+      }
+
+      template<typename Func>
+      void for_each_linear(double factor, Func& func) const
+      {
+        func(coefficient * factor, variable);
+      }
+
+      template<typename Func>
+      void for_each_quadratic([[maybe_unused]] double factor, [[maybe_unused]] Func& func) const
+      {
+      }
+    };
+
+    // Storage is either an owned expression or a pointer to an expression
+    template<typename Storage>
+    struct ExprImpl {
+      Storage storage;
+
+      const auto& expr() const
+      {
+        if constexpr (std::is_pointer_v<Storage>) {
+          return *storage;
+        } else {
+          return storage;
+        }
+      }
+
+      double constant() const
+      {
+        return expr().constant();
+      }
+
+      std::size_t linear_count() const
+      {
+        return expr().linear_terms().size();
+      }
+
+      std::size_t quadratic_count() const
+      {
+        if constexpr (std::is_same_v<std::decay_t<decltype(expr())>, QExpr>) {
+          return expr().quadratic_terms().size();
+        } else {
+          return 0;
+        }
+      }
+
+      template<typename Func>
+      void for_each_linear(double factor, Func& func) const
+      {
+        for (const auto& term : expr().linear_terms()) {
+          func(term.coefficient * factor, term.variable);
+        }
+      }
+
+      template<typename Func>
+      void for_each_quadratic([[maybe_unused]] double factor, [[maybe_unused]] Func& func) const
+      {
+        if constexpr (std::is_same_v<std::decay_t<decltype(expr())>, QExpr>) {
+          for (const auto& term : expr().quadratic_terms()) {
+            func(term.coefficient * factor, term.variables[0], term.variables[1]);
+          }
+        }
+      }
+    };
+
+    template<typename Lhs, typename Rhs>
+    struct SumImpl {
+      Lhs lhs;
+      Rhs rhs;
+      double sign; // 1.0 for a sum, -1.0 for a difference
+
+      double constant() const
+      {
+        return lhs.constant() + sign * rhs.constant();
+      }
+
+      std::size_t linear_count() const
+      {
+        return lhs.linear_count() + rhs.linear_count();
+      }
+
+      std::size_t quadratic_count() const
+      {
+        return lhs.quadratic_count() + rhs.quadratic_count();
+      }
+
+      template<typename Func>
+      void for_each_linear(double factor, Func& func) const
+      {
+        lhs.for_each_linear(factor, func);
+        rhs.for_each_linear(sign * factor, func);
+      }
+
+      template<typename Func>
+      void for_each_quadratic(double factor, Func& func) const
+      {
+        lhs.for_each_quadratic(factor, func);
+        rhs.for_each_quadratic(sign * factor, func);
+      }
+    };
+
+    template<typename Operand>
+    struct ScaledImpl {
+      Operand operand;
+      double multiplier;
+
+      double constant() const
+      {
+        return operand.constant() * multiplier;
+      }
+
+      std::size_t linear_count() const
+      {
+        return operand.linear_count();
+      }
+
+      std::size_t quadratic_count() const
+      {
+        return operand.quadratic_count();
+      }
+
+      template<typename Func>
+      void for_each_linear(double factor, Func& func) const
+      {
+        operand.for_each_linear(multiplier * factor, func);
+      }
+
+      template<typename Func>
+      void for_each_quadratic(double factor, Func& func) const
+      {
+        operand.for_each_quadratic(multiplier * factor, func);
+      }
+    };
+
+    template<typename Operand>
+    struct QuotientImpl {
+      Operand operand;
+      double divisor;
+
+      double constant() const
+      {
+        return operand.constant() / divisor;
+      }
+
+      std::size_t linear_count() const
+      {
+        return operand.linear_count();
+      }
+
+      std::size_t quadratic_count() const
+      {
+        return operand.quadratic_count();
+      }
+
+      template<typename Func>
+      void for_each_linear(double factor, Func& func) const
+      {
+        auto divide = [&](double coefficient, VariableId variable) {
+          func(coefficient / divisor, variable);
+        };
+
+        operand.for_each_linear(factor, divide);
+      }
+
+      template<typename Func>
+      void for_each_quadratic(double factor, Func& func) const
+      {
+        auto divide = [&](double coefficient, VariableId variable1, VariableId variable2) {
+          func(coefficient / divisor, variable1, variable2);
+        };
+
+        operand.for_each_quadratic(factor, divide);
+      }
+    };
+
+    // product of two linear operands
+    template<typename Lhs, typename Rhs>
+    struct ProductImpl {
+      Lhs lhs;
+      Rhs rhs;
+
+      double constant() const
+      {
+        return lhs.constant() * rhs.constant();
+      }
+
+      std::size_t linear_count() const
+      {
+        return lhs.linear_count() + rhs.linear_count();
+      }
+
+      std::size_t quadratic_count() const
+      {
+        return lhs.linear_count() * rhs.linear_count();
+      }
+
+      template<typename Func>
+      void for_each_linear(double factor, Func& func) const
+      {
+        if (const double lhs_constant = lhs.constant(); lhs_constant != 0.0) {
+          rhs.for_each_linear(lhs_constant * factor, func);
+        }
+
+        if (const double rhs_constant = rhs.constant(); rhs_constant != 0.0) {
+          lhs.for_each_linear(rhs_constant * factor, func);
+        }
+      }
+
+      template<typename Func>
+      void for_each_quadratic(double factor, Func& func) const
+      {
+        auto outer = [&](double lhs_coefficient, VariableId lhs_variable) {
+          auto inner = [&](double coefficient, VariableId rhs_variable) {
+            func(coefficient, lhs_variable, rhs_variable);
+          };
+
+          rhs.for_each_linear(lhs_coefficient, inner);
+        };
+
+        lhs.for_each_linear(factor, outer);
+      }
+    };
+
+    enum class ExprKind : uint8_t {
+      None,
+      Scalar,
+      Linear,
+      Quadratic,
+    };
+
+    template<typename T>
+    struct ExprKindOf {
+      static constexpr ExprKind value = (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>) ? ExprKind::Scalar : ExprKind::None;
+    };
+
+    template<>
+    struct ExprKindOf<VariableId> {
+      static constexpr ExprKind value = ExprKind::Linear;
+    };
+
+    template<>
+    struct ExprKindOf<LExpr> {
+      static constexpr ExprKind value = ExprKind::Linear;
+    };
+
+    template<typename Impl>
+    struct ExprKindOf<LExprNode<Impl>> {
+      static constexpr ExprKind value = ExprKind::Linear;
+    };
+
+    template<>
+    struct ExprKindOf<QExpr> {
+      static constexpr ExprKind value = ExprKind::Quadratic;
+    };
+
+    template<typename Impl>
+    struct ExprKindOf<QExprNode<Impl>> {
+      static constexpr ExprKind value = ExprKind::Quadratic;
+    };
+
+    template<typename T>
+    constexpr ExprKind expr_kind = ExprKindOf<std::remove_cv_t<std::remove_reference_t<T>>>::value;
+
+    template<typename T>
+    constexpr bool is_expr = expr_kind<T> == ExprKind::Linear || expr_kind<T> == ExprKind::Quadratic;
+
+    template<typename L, typename R>
+    constexpr bool is_additive = (is_expr<L> && expr_kind<R> != ExprKind::None) || (is_expr<R> && expr_kind<L> != ExprKind::None);
+
+    template<typename L, typename R>
+    constexpr bool is_scaling = is_expr<L> && expr_kind<R> == ExprKind::Scalar;
+
+    template<typename L, typename R>
+    constexpr bool is_product = expr_kind<L> == ExprKind::Linear && expr_kind<R> == ExprKind::Linear;
+
+    template<typename L, typename R>
+    constexpr bool is_quadratic_result = expr_kind<L> == ExprKind::Quadratic || expr_kind<R> == ExprKind::Quadratic;
+
+    template<typename T>
+    auto to_impl(T&& operand)
+    {
+      using Type = std::remove_cv_t<std::remove_reference_t<T>>;
+
+      if constexpr (expr_kind<T> == ExprKind::Scalar) {
+        return ConstantImpl{ static_cast<double>(operand) };
+      } else if constexpr (std::is_same_v<Type, VariableId>) {
+        return VariableImpl{ 1.0, operand };
+      } else if constexpr (std::is_same_v<Type, LExpr> || std::is_same_v<Type, QExpr>) {
+        if constexpr (std::is_lvalue_reference_v<T>) {
+          return ExprImpl<const Type*>{ &operand };
+        } else {
+          return ExprImpl<Type>{ std::move(operand) };
+        }
+      } else {
+        return std::forward<T>(operand).impl();
+      }
+    }
+
+    template<bool Quadratic, typename Impl>
+    auto make_node(Impl impl)
+    {
+      if constexpr (Quadratic) {
+        return QExprNode<Impl>(std::move(impl));
+      } else {
+        return LExprNode<Impl>(std::move(impl));
+      }
+    }
+
   }
 
-  inline QExpr operator-(const QExpr& lhs, const QExpr& rhs)
+  // lazy linear expression
+  template<typename Impl>
+  class LExprNode {
+  public:
+    explicit LExprNode(Impl impl)
+    : m_impl(std::move(impl))
+    {
+    }
+
+    const Impl& impl() const&
+    {
+      return m_impl;
+    }
+
+    Impl&& impl() &&
+    {
+      return std::move(m_impl);
+    }
+
+  private:
+    Impl m_impl;
+  };
+
+  // lazy quadratic expression
+  template<typename Impl>
+  class QExprNode {
+  public:
+    explicit QExprNode(Impl impl)
+    : m_impl(std::move(impl))
+    {
+    }
+
+    const Impl& impl() const&
+    {
+      return m_impl;
+    }
+
+    Impl&& impl() &&
+    {
+      return std::move(m_impl);
+    }
+
+  private:
+    Impl m_impl;
+  };
+
+  template<typename Impl>
+  LExpr::LExpr(const LExprNode<Impl>& node)
+  : m_constant(node.impl().constant())
   {
-    QExpr expr(lhs);
-    expr -= rhs;
-    return expr;
+    m_linear_terms.reserve(node.impl().linear_count());
+
+    auto append = [this](double coefficient, VariableId variable) {
+      m_linear_terms.push_back({ coefficient, variable });
+    };
+
+    node.impl().for_each_linear(1.0, append);
+    normalize();
   }
 
-  inline QExpr operator*(double lhs, const QExpr& rhs)
+  template<typename Impl>
+  QExpr::QExpr(const LExprNode<Impl>& node)
+  : m_constant(node.impl().constant())
   {
-    QExpr expr(rhs);
-    expr *= lhs;
-    return expr;
+    m_linear_terms.reserve(node.impl().linear_count());
+
+    auto append = [this](double coefficient, VariableId variable) {
+      m_linear_terms.push_back({ coefficient, variable });
+    };
+
+    node.impl().for_each_linear(1.0, append);
+    normalize();
   }
 
-  inline QExpr operator*(const QExpr& lhs, double rhs)
+  template<typename Impl>
+  QExpr::QExpr(const QExprNode<Impl>& node)
+  : m_constant(node.impl().constant())
   {
-    QExpr expr(lhs);
-    expr *= rhs;
-    return expr;
+    m_linear_terms.reserve(node.impl().linear_count());
+    m_quadratic_terms.reserve(node.impl().quadratic_count());
+
+    auto append_linear = [this](double coefficient, VariableId variable) {
+      m_linear_terms.push_back({ coefficient, variable });
+    };
+
+    auto append_quadratic = [this](double coefficient, VariableId variable1, VariableId variable2) {
+      if (variable1 > variable2) {
+        std::swap(variable1, variable2);
+      }
+
+      m_quadratic_terms.push_back({
+          coefficient, { variable1, variable2 }
+      });
+    };
+
+    node.impl().for_each_linear(1.0, append_linear);
+    node.impl().for_each_quadratic(1.0, append_quadratic);
+    normalize();
   }
 
-  inline QExpr operator/(const QExpr& lhs, double rhs)
+  /*
+   * Operators
+   */
+
+  template<typename E, typename = std::enable_if_t<details::is_expr<E>>>
+  auto operator-(E&& expr)
   {
-    QExpr expr(lhs);
-    expr /= rhs;
-    return expr;
+    return details::make_node<details::is_quadratic_result<E, E>>(details::ScaledImpl<decltype(details::to_impl(std::forward<E>(expr)))>{ details::to_impl(std::forward<E>(expr)), -1.0 });
   }
 
-  inline QExpr operator*(VariableId lhs, VariableId rhs)
+  template<typename L, typename R, typename = std::enable_if_t<details::is_additive<L, R>>>
+  auto operator+(L&& lhs, R&& rhs)
   {
-    return { lhs, rhs };
+    using Impl = details::SumImpl<decltype(details::to_impl(std::forward<L>(lhs))), decltype(details::to_impl(std::forward<R>(rhs)))>;
+    return details::make_node<details::is_quadratic_result<L, R>>(Impl{ details::to_impl(std::forward<L>(lhs)), details::to_impl(std::forward<R>(rhs)), 1.0 });
   }
 
-  inline QExpr operator*(VariableId lhs, const LExpr& rhs)
+  template<typename L, typename R, typename = std::enable_if_t<details::is_additive<L, R>>>
+  auto operator-(L&& lhs, R&& rhs)
   {
-    return { LExpr(lhs), rhs };
+    using Impl = details::SumImpl<decltype(details::to_impl(std::forward<L>(lhs))), decltype(details::to_impl(std::forward<R>(rhs)))>;
+    return details::make_node<details::is_quadratic_result<L, R>>(Impl{ details::to_impl(std::forward<L>(lhs)), details::to_impl(std::forward<R>(rhs)), -1.0 });
   }
 
-  inline QExpr operator*(const LExpr& lhs, VariableId rhs)
+  template<typename L, typename R, typename = std::enable_if_t<details::is_scaling<L, R> || details::is_scaling<R, L> || details::is_product<L, R>>>
+  auto operator*(L&& lhs, R&& rhs)
   {
-    return { lhs, LExpr(rhs) };
+    if constexpr (details::is_scaling<L, R>) {
+      using Impl = details::ScaledImpl<decltype(details::to_impl(std::forward<L>(lhs)))>;
+      return details::make_node<details::is_quadratic_result<L, L>>(Impl{ details::to_impl(std::forward<L>(lhs)), static_cast<double>(rhs) });
+    } else if constexpr (details::is_scaling<R, L>) {
+      using Impl = details::ScaledImpl<decltype(details::to_impl(std::forward<R>(rhs)))>;
+      return details::make_node<details::is_quadratic_result<R, R>>(Impl{ details::to_impl(std::forward<R>(rhs)), static_cast<double>(lhs) });
+    } else {
+      using Impl = details::ProductImpl<decltype(details::to_impl(std::forward<L>(lhs))), decltype(details::to_impl(std::forward<R>(rhs)))>;
+      return details::make_node<true>(Impl{ details::to_impl(std::forward<L>(lhs)), details::to_impl(std::forward<R>(rhs)) });
+    }
   }
 
-  inline QExpr operator*(const LExpr& lhs, const LExpr& rhs)
+  template<typename L, typename R, typename = std::enable_if_t<details::is_scaling<L, R>>>
+  auto operator/(L&& lhs, R rhs)
   {
-    return { lhs, rhs };
+    using Impl = details::QuotientImpl<decltype(details::to_impl(std::forward<L>(lhs)))>;
+    return details::make_node<details::is_quadratic_result<L, L>>(Impl{ details::to_impl(std::forward<L>(lhs)), static_cast<double>(rhs) });
   }
 
 }
@@ -3,15 +3,73 @@
 #ifndef LQP_GLPK_SOLVER_H
 #define LQP_GLPK_SOLVER_H
 
+#include <cstddef>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "Api.h"
+#include "CompiledProblem.h"
+#include "Inequality.h"
+#include "Problem.h"
 #include "Solver.h"
 
 namespace lqp {
 
+  // A GLPK model that stays alive between solves. The model can be
+  // modified incrementally and each solve starts from the basis of the
+  // previous one. The constraints added to the session are numbered after
+  // the constraints of the original problem.
+  class LQP_API GlpkSession {
+  public:
+    GlpkSession();
+    ~GlpkSession();
+
+    GlpkSession(const GlpkSession&) = delete;
+    GlpkSession& operator=(const GlpkSession&) = delete;
+
+    GlpkSession(GlpkSession&& other) noexcept;
+    GlpkSession& operator=(GlpkSession&& other) noexcept;
+
+    bool loaded() const;
+
+    void set_variable_range(VariableId variable, VariableRange range);
+    void set_objective_coefficient(VariableId variable, double coefficient);
+
+    void set_constraint_range(ConstraintId constraint, VariableRange range);
+    // only linear constraints can be added to a session
+    std::optional<ConstraintId> add_constraint(Inequality inequality, std::string name = "");
+    void remove_constraint(ConstraintId constraint);
+
+    Solution solve(const SolverConfig& config = SolverConfig());
+
+  private:
+    friend class GlpkSolver;
+
+    struct State;
+    std::unique_ptr<State> m_state;
+  };
+
   class LQP_API GlpkSolver : public Solver {
   public:
     bool available() const override;
     Solution solve(const Problem& problem, const SolverConfig& config) override;
+    Solution solve(const CompiledProblem& problem, const SolverConfig& config = SolverConfig());
+
+    // solves independent problems on worker_count threads (0 for the number
+    // of cores), the solutions are in the order of the problems, the output
+    // files of the configuration are ignored
+    std::vector<Solution> solve_batch(const std::vector<Problem>& problems, const SolverConfig& config = SolverConfig(), std::size_t worker_count = 0);
+
+    // the session is not loaded if the problem can not be linearized
+    GlpkSession open(const Problem& problem);
+
+    // glpk can be used from several threads if it was built with thread
+    // local storage, each thread must then release its resources
+    static bool thread_safe();
+    static void release_thread_resources();
   };
 
 }
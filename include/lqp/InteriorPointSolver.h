@@ -0,0 +1,45 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_INTERIOR_POINT_SOLVER_H
+#define LQP_INTERIOR_POINT_SOLVER_H
+
+#include <cstddef>
+
+#include "Api.h"
+#include "CompiledProblem.h"
+#include "Solver.h"
+
+namespace lqp {
+
+  struct LQP_API InteriorPointOptions {
+    // finishes with the simplex from a basis guessed from the interior
+    // solution, to get a basic solution
+    bool crossover = false;
+    // threads of the Cholesky factorization, 0 for the hardware concurrency
+    std::size_t thread_count = 0;
+  };
+
+  // Native primal-dual interior point method (Mehrotra predictor-corrector)
+  // for large sparse linear problems. The normal equations are solved with
+  // a supernodal sparse Cholesky factorization, computed once per
+  // iteration with a minimum degree ordering. When the interior point
+  // method does not converge, the status of the problem (infeasible or
+  // unbounded) is found with the simplex. Only continuous problems with a
+  // linear objective are supported and the output files of the
+  // configuration are ignored.
+  class LQP_API InteriorPointSolver : public Solver {
+  public:
+    InteriorPointSolver() = default;
+    InteriorPointSolver(InteriorPointOptions options);
+
+    bool available() const override;
+    Solution solve(const Problem& problem, const SolverConfig& config) override;
+    Solution solve(const CompiledProblem& problem, const SolverConfig& config = SolverConfig());
+
+  private:
+    InteriorPointOptions m_options;
+  };
+
+}
+
+#endif // LQP_INTERIOR_POINT_SOLVER_H
@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_MODEL_READER_H
+#define LQP_MODEL_READER_H
+
+#include <cstdint>
+
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+#include "Api.h"
+#include "Problem.h"
+
+namespace lqp {
+
+  enum class MpsFormat : uint8_t {
+    Free,  // fields separated by spaces, names without spaces
+    Fixed, // fields in fixed columns
+  };
+
+  // Readers of the MPS format and of the CPLEX LP format. The files are
+  // mapped in memory and parsed in a single pass, the variables are found
+  // by name in a hash table and the problem is built at the end with the
+  // batch functions of Problem. The quadratic objectives (QUADOBJ and
+  // QMATRIX sections in MPS) and the quadratic constraints of the LP format
+  // are supported, not the semi-continuous variables nor the special
+  // ordered sets. The bounds whose absolute value is at least 1e30 are
+  // infinite. The readers return std::nullopt if the file can not be read
+  // or is not valid, in particular an MPS file without its NAME, ROWS and
+  // ENDATA sections.
+  LQP_API std::optional<Problem> read_mps(const std::filesystem::path& path, MpsFormat format = MpsFormat::Free);
+  LQP_API std::optional<Problem> read_lp(const std::filesystem::path& path);
+
+  // the same from a buffer
+  LQP_API std::optional<Problem> parse_mps(std::string_view content, MpsFormat format = MpsFormat::Free);
+  LQP_API std::optional<Problem> parse_lp(std::string_view content);
+
+}
+
+#endif // LQP_MODEL_READER_H
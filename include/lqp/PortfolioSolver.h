@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_PORTFOLIO_SOLVER_H
+#define LQP_PORTFOLIO_SOLVER_H
+
+#include <vector>
+
+#include "Api.h"
+#include "Solver.h"
+
+namespace lqp {
+
+  // options of a variant, applied on top of the configuration of the solve
+  struct LQP_API PortfolioVariant {
+    bool presolve = false;
+    Branching branching = Branching::DriebeckTomlin;
+    Backtracking backtracking = Backtracking::BestLocalBound;
+  };
+
+  // Runs several variants of GlpkSolver concurrently on the same problem.
+  // The first definitive result (optimal, infeasible or unbounded) stops the
+  // other variants. Otherwise, the best feasible solution at the timeout is
+  // returned. Setting the stop flag of the configuration stops all the
+  // variants, but GLPK only polls it in the branch and bound, not while it
+  // solves the relaxation of the root. A linear problem, or a problem
+  // solved without use_mip, is solved once with the first variant. Only
+  // the first variant writes messages and output files.
+  class LQP_API PortfolioSolver : public Solver {
+  public:
+    // a default set of variants
+    PortfolioSolver();
+    PortfolioSolver(std::vector<PortfolioVariant> variants);
+
+    bool available() const override;
+    Solution solve(const Problem& problem, const SolverConfig& config) override;
+
+  private:
+    std::vector<PortfolioVariant> m_variants;
+  };
+
+}
+
+#endif // LQP_PORTFOLIO_SOLVER_H
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_PRESOLVE_H
+#define LQP_PRESOLVE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+#include "Api.h"
+#include "CompiledProblem.h"
+#include "Problem.h"
+#include "Solution.h"
+#include "Solver.h"
+
+namespace lqp {
+
+  // Reduces a problem before it is given to a backend: empty and singleton
+  // rows and columns, fixed variables, duplicate rows and redundant rows
+  // are removed, the bounds of the variables are tightened and, for a mixed
+  // integer problem, the coefficients of the binary variables are
+  // tightened. The variables of the quadratic part of the objective are
+  // kept. The solution of the reduced problem is mapped back to the
+  // variables of the original problem with postsolve().
+  class LQP_API Presolve {
+  public:
+    // the integrality of the variables is used only when use_mip is set
+    Presolve(const Problem& problem, bool use_mip = true);
+    Presolve(const CompiledProblem& problem, bool use_mip = true);
+
+    // false if the problem has been proven infeasible
+    bool feasible() const;
+
+    // the reduced problem
+    const Problem& problem() const;
+    std::size_t variable_count() const;
+
+    std::size_t removed_variable_count() const;
+    std::size_t removed_constraint_count() const;
+
+    Solution postsolve(const Solution& solution) const;
+
+  private:
+    class Reducer;
+
+    // removed variable, undone in reverse order
+    struct Reduction {
+      enum Kind : uint8_t {
+        Fixed,      // the variable has the value
+        Slack,      // the variable is chosen in its bounds to satisfy the row
+        Substitute, // the variable is computed from the equality row
+      };
+
+      Kind kind;
+      uint32_t variable;
+      double value; // or coefficient of the variable in the row
+      double lower; // bounds of the row
+      double upper;
+      double variable_lower;
+      double variable_upper;
+      std::size_t term_start; // other terms of the row
+      std::size_t term_end;
+    };
+
+    void reduce(const CompiledProblem& problem, bool use_mip);
+
+    bool m_identity = false; // the problem could not be compiled
+    bool m_feasible = true;
+    Problem m_problem;
+    std::size_t m_variable_count = 0;
+    std::size_t m_removed_constraint_count = 0;
+
+    std::vector<uint32_t> m_kept_variables; // reduced -> original
+    std::vector<Reduction> m_reductions;
+    std::vector<uint32_t> m_term_variables;
+    std::vector<double> m_term_coefficients;
+  };
+
+  // Presolves the problem, solves the reduced problem with another solver
+  // and maps the solution back to the original problem.
+  class LQP_API PresolveSolver : public Solver {
+  public:
+    PresolveSolver(Solver& solver);
+
+    bool available() const override;
+    Solution solve(const Problem& problem, const SolverConfig& config) override;
+
+  private:
+    Solver* m_solver = nullptr;
+  };
+
+}
+
+#endif // LQP_PRESOLVE_H
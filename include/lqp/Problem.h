@@ -5,12 +5,17 @@
 
 #include <cstdint>
 
+#include <array>
 #include <iosfwd>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "Api.h"
+#include "CompiledProblem.h"
 #include "Expr.h"
 #include "Inequality.h"
 #include "Variable.h"
@@ -23,11 +28,63 @@ namespace lqp {
     std::size_t index;
   };
 
+  // contiguous variables added at once
+  struct LQP_API VariableIdRange {
+    std::size_t first = 0;
+    std::size_t count = 0;
+
+    std::size_t size() const
+    {
+      return count;
+    }
+
+    VariableId operator[](std::size_t index) const
+    {
+      return VariableId{ first + index };
+    }
+  };
+
+  // contiguous constraints added at once
+  struct LQP_API ConstraintIdRange {
+    std::size_t first = 0;
+    std::size_t count = 0;
+
+    std::size_t size() const
+    {
+      return count;
+    }
+
+    ConstraintId operator[](std::size_t index) const
+    {
+      return ConstraintId{ first + index };
+    }
+  };
+
   enum class Sense : uint8_t {
     Minimize,
     Maximize,
   };
 
+  // result of Problem::check_feasibility(), a violation is counted when it
+  // is above the tolerance but the maximums include all the violations
+  struct LQP_API FeasibilityReport {
+    double max_bound_violation = 0.0;
+    double max_constraint_violation = 0.0;
+    double max_integrality_violation = 0.0;
+
+    std::vector<std::size_t> violated_variables; // out of their range
+    std::vector<std::size_t> violated_constraints;
+    std::vector<std::size_t> fractional_variables;
+
+    // indexed by VariableCategory
+    std::array<std::size_t, 3> integrality_violations = {};
+
+    bool feasible() const
+    {
+      return violated_variables.empty() && violated_constraints.empty() && fractional_variables.empty();
+    }
+  };
+
   class LQP_API Problem {
   public:
     VariableId add_variable(VariableCategory category, std::string name = "");
@@ -35,14 +92,31 @@ namespace lqp {
 
     ConstraintId add_constraint(Inequality inequality, std::string name = "");
 
-    void set_objective(Sense sense, const LExpr& expr, std::string name = "");
+    // batch construction
+    VariableIdRange add_variables(std::size_t count, VariableCategory category);
+    VariableIdRange add_variables(std::size_t count, VariableCategory category, VariableRange range);
+
+    // rows in compressed sparse row format: the coefficients of row i are
+    // at [row_starts[i], row_starts[i + 1]) in col_indices and values, the
+    // bounds of the rows may be infinite, the names are optional
+    ConstraintIdRange add_rows(const std::vector<std::size_t>& row_starts, const std::vector<std::size_t>& col_indices, const std::vector<double>& values, const std::vector<double>& lower, const std::vector<double>& upper, std::vector<std::string> names = {});
+
+    // the objective may be quadratic, only the native QP backend supports it
+    void set_objective(Sense sense, const QExpr& expr, std::string name = "");
 
     std::string variable_name(VariableId var) const;
 
     bool is_linear() const;
     std::optional<Problem> linearize() const;
 
-    bool is_feasible(const Solution& solution) const;
+    // linearizes the problem if needed, std::nullopt if it can not be
+    // linearized or has more than 2^32 - 1 variables or nonzeros
+    std::optional<CompiledProblem> compile() const;
+
+    bool is_feasible(const Solution& solution, double tolerance = 0.0) const;
+    // the variables and the constraints are checked in chunks on several
+    // threads, 0 for the hardware concurrency
+    FeasibilityReport check_feasibility(const Solution& solution, double tolerance = 1e-6, std::size_t thread_count = 0) const;
     double compute_objective_value(const Solution& solution) const;
 
     void print_to(std::ostream& out) const;
@@ -51,6 +125,8 @@ namespace lqp {
     void print_expr_to(const QExpr& expr, std::ostream& out) const;
 
     friend class Solver;
+    friend class ActivityTracker;
+    friend class BatchEvaluator;
 
     struct Variable {
       VariableCategory category;
@@ -66,16 +142,70 @@ namespace lqp {
 
     struct Objective {
       Sense sense;
-      LExpr expression;
+      QExpr expression;
       std::string name;
     };
 
-    bool linearize_constraint(const Constraint& constraint, Problem& result) const;
+    struct ProductHash {
+      std::size_t operator()(const std::pair<std::size_t, std::size_t>& product) const;
+    };
+
+    // auxiliary variables and constraints that replace the non-linear
+    // constraints, the linear constraints of the problem are kept as is
+    struct Linearization {
+      static constexpr std::size_t Auxiliary = std::size_t(-1);
+
+      std::size_t variable_count = 0; // variables of the problem
+      std::vector<Variable> variables;
+      std::vector<Constraint> constraints;
+      std::vector<std::size_t> origins; // replaced constraint or Auxiliary
+
+      // auxiliary variable of each product, shared by all the constraints
+      std::unordered_map<std::pair<std::size_t, std::size_t>, VariableId, ProductHash> products;
+      // x = lower + sum 2^k bits[k] for an expanded integer variable x,
+      // lower is the rounded lower bound of x
+      struct Expansion {
+        double lower;
+        std::vector<VariableId> bits;
+      };
+
+      std::unordered_map<std::size_t, Expansion> expansions;
+
+      VariableId add_variable(VariableCategory category, VariableRange range);
+      void add_constraint(Inequality inequality);
+      void resize_problem(std::size_t count);
+    };
+
+    // the linearization is computed on demand and extended with the
+    // constraints added since the last time
+    struct LinearizationCache {
+      LinearizationCache() = default;
+      LinearizationCache(const LinearizationCache& other);
+      LinearizationCache(LinearizationCache&& other) noexcept;
+      LinearizationCache& operator=(const LinearizationCache& other);
+      LinearizationCache& operator=(LinearizationCache&& other) noexcept;
+
+      mutable std::mutex mutex;
+      std::size_t constraint_count = 0; // constraints of the problem already processed
+      bool failed = false;
+      Linearization linearization;
+    };
+
+    static Constraint make_constraint(Inequality inequality, std::string name);
+
+    // nullptr if a constraint can not be linearized
+    const Linearization* linearization() const;
+    bool linearize_constraint(std::size_t index, Linearization& linearization) const;
+    std::pair<VariableCategory, VariableRange> product_variable(VariableId variable, const Linearization& linearization) const;
+    std::optional<VariableId> linearize_product(VariableId v0, VariableId v1, Linearization& linearization) const;
+    const std::vector<VariableId>* binary_expansion(VariableId variable, double lower, double upper, Linearization& linearization) const;
 
     std::vector<Variable> m_variables;
     std::vector<Constraint> m_constraints;
 
     Objective m_objective;
+
+    mutable LinearizationCache m_linearization_cache;
   };
 
   inline std::ostream& operator<<(std::ostream& out, const Problem& problem)
@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_SIMPLEX_SOLVER_H
+#define LQP_SIMPLEX_SOLVER_H
+
+#include <cstdint>
+
+#include <vector>
+
+#include "Api.h"
+#include "CompiledProblem.h"
+#include "Solver.h"
+
+namespace lqp {
+
+  // the status of a variable in a basis, the variables are the columns of
+  // the compiled problem followed by one logical variable per constraint
+  enum class BasisStatus : uint8_t {
+    Basic,
+    AtLower,
+    AtUpper,
+    Free, // non-basic at zero
+  };
+
+  // Native bounded dual simplex working on the compiled problem. The final
+  // basis of a solve is kept and used as the starting basis of the next
+  // solve if the dimensions match. Only continuous problems with a linear
+  // objective are supported and the output files of the configuration are
+  // ignored.
+  class LQP_API SimplexSolver : public Solver {
+  public:
+    bool available() const override;
+    Solution solve(const Problem& problem, const SolverConfig& config) override;
+    Solution solve(const CompiledProblem& problem, const SolverConfig& config = SolverConfig());
+
+    const std::vector<BasisStatus>& basis() const;
+    void set_basis(std::vector<BasisStatus> basis);
+    void clear_basis();
+
+  private:
+    std::vector<BasisStatus> m_basis;
+  };
+
+}
+
+#endif // LQP_SIMPLEX_SOLVER_H
@@ -3,9 +3,10 @@
 #ifndef LQP_SOLUTION_H
 #define LQP_SOLUTION_H
 
+#include <cstddef>
 #include <cstdint>
 
-#include <map>
+#include <vector>
 
 #include "Api.h"
 #include "Variable.h"
@@ -26,6 +27,7 @@ namespace lqp {
   class LQP_API Solution {
   public:
     Solution(SolutionStatus status);
+    Solution(SolutionStatus status, std::vector<double> values);
 
     SolutionStatus status() const;
 
@@ -35,9 +37,12 @@ namespace lqp {
     void set_value(VariableId variable, double value);
     double value(VariableId variable) const;
 
+    // values indexed by variable, the missing values are 0
+    const std::vector<double>& values() const;
+
   private:
     SolutionStatus m_status = SolutionStatus::NotSolved;
-    std::map<VariableId, double> m_values;
+    std::vector<double> m_values;
   };
 
 }
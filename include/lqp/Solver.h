@@ -3,8 +3,11 @@
 #ifndef LQP_SOLVER_H
 #define LQP_SOLVER_H
 
+#include <atomic>
 #include <chrono>
 #include <filesystem>
+#include <optional>
+#include <vector>
 
 #include "Api.h"
 #include "Problem.h"
@@ -12,11 +15,38 @@
 
 namespace lqp {
 
+  // the variable chosen for branching in a MIP
+  enum class Branching : uint8_t {
+    FirstFractional,
+    LastFractional,
+    MostFractional,
+    DriebeckTomlin,
+  };
+
+  // the next subproblem explored in a MIP
+  enum class Backtracking : uint8_t {
+    DepthFirst,
+    BreadthFirst,
+    BestLocalBound,
+    BestProjection,
+  };
+
+  // the method for continuous problems and relaxations
+  enum class Algorithm : uint8_t {
+    Simplex,
+    InteriorPoint,
+  };
+
   struct LQP_API SolverConfig {
     bool use_mip = false;
     bool verbose = true;
     bool presolve = false;
+    Algorithm algorithm = Algorithm::Simplex;
+    Branching branching = Branching::DriebeckTomlin;
+    Backtracking backtracking = Backtracking::BestLocalBound;
     std::chrono::milliseconds timeout = std::chrono::milliseconds::max();
+    // when set to true, a MIP solve stops with its best solution
+    const std::atomic<bool>* stop = nullptr;
     std::filesystem::path problem_output;
     std::filesystem::path solution_output;
   };
@@ -36,9 +66,10 @@ namespace lqp {
     virtual Solution solve(const Problem& problem, const SolverConfig& config = SolverConfig()) = 0;
 
   protected:
-    static std::vector<Problem::Variable> variables(const Problem& problem);
-    static std::vector<Problem::Constraint> constraints(const Problem& problem);
-    static Problem::Objective objective(const Problem& problem);
+    static const std::vector<Problem::Variable>& variables(const Problem& problem);
+    static const std::vector<Problem::Constraint>& constraints(const Problem& problem);
+    static const Problem::Objective& objective(const Problem& problem);
+    static const Problem::Linearization* linearization(const Problem& problem);
   };
 
   class LQP_API NullSolver : public Solver {
@@ -0,0 +1,62 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_TERM_SPAN_H
+#define LQP_TERM_SPAN_H
+
+#include <cassert>
+#include <cstddef>
+
+namespace lqp {
+
+  // read-only view on a contiguous sequence of terms, it is invalidated
+  // by any modification of the object that owns the terms
+  template<typename T>
+  class TermSpan {
+  public:
+    constexpr TermSpan() = default;
+
+    constexpr TermSpan(const T* data, std::size_t size)
+    : m_data(data)
+    , m_size(size)
+    {
+    }
+
+    constexpr const T* data() const
+    {
+      return m_data;
+    }
+
+    constexpr std::size_t size() const
+    {
+      return m_size;
+    }
+
+    constexpr bool empty() const
+    {
+      return m_size == 0;
+    }
+
+    constexpr const T* begin() const
+    {
+      return m_data;
+    }
+
+    constexpr const T* end() const
+    {
+      return m_data + m_size;
+    }
+
+    constexpr const T& operator[](std::size_t index) const
+    {
+      assert(index < m_size);
+      return m_data[index];
+    }
+
+  private:
+    const T* m_data = nullptr;
+    std::size_t m_size = 0;
+  };
+
+}
+
+#endif // LQP_TERM_SPAN_H
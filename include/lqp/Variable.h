@@ -54,6 +54,8 @@ namespace lqp {
     double upper = 0.0;
 
     bool has_value(double value) const;
+    // 0 if the value is in the range
+    double distance(double value) const;
   };
 
   LQP_API VariableRange upper_bound(double value);
@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include <lqp/ActivityTracker.h>
+// clang-format on
+
+#include <cassert>
+
+namespace lqp {
+
+  ActivityTracker::ActivityTracker(const Problem& problem, const Solution& solution, double tolerance)
+  : m_problem(&problem)
+  , m_tolerance(tolerance)
+  {
+    const std::size_t variable_count = problem.m_variables.size();
+    const std::size_t constraint_count = problem.m_constraints.size();
+
+    m_values.resize(variable_count);
+
+    for (std::size_t variable = 0; variable < variable_count; ++variable) {
+      m_values[variable] = solution.value(VariableId{ variable });
+    }
+
+    // the terms are visited twice, to count the entries of each variable
+    // and then to store them
+
+    auto visit = [](const QExpr& expression, std::size_t row, auto func) {
+      for (const auto& term : expression.linear_terms()) {
+        func(to_index(term.variable), Entry{ row, term.coefficient, NoVariable });
+      }
+
+      for (const auto& term : expression.quadratic_terms()) {
+        const std::size_t v0 = to_index(term.variables[0]);
+        const std::size_t v1 = to_index(term.variables[1]);
+        func(v0, Entry{ row, term.coefficient, v1 });
+
+        if (v1 != v0) {
+          func(v1, Entry{ row, term.coefficient, v0 });
+        }
+      }
+    };
+
+    auto build = [&](auto for_each_expression, std::vector<std::size_t>& starts, std::vector<Entry>& entries) {
+      starts.assign(variable_count + 1, 0);
+
+      for_each_expression([&](std::size_t variable, [[maybe_unused]] const Entry& entry) { ++starts[variable + 1]; });
+
+      for (std::size_t variable = 0; variable < variable_count; ++variable) {
+        starts[variable + 1] += starts[variable];
+      }
+
+      entries.resize(starts.back());
+      std::vector<std::size_t> positions(starts.begin(), starts.end() - 1);
+
+      for_each_expression([&](std::size_t variable, const Entry& entry) { entries[positions[variable]++] = entry; });
+    };
+
+    build(
+        [&](auto func) {
+          for (std::size_t row = 0; row < constraint_count; ++row) {
+            visit(problem.m_constraints[row].expression, row, func);
+          }
+        },
+        m_column_starts, m_entries
+    );
+
+    build([&](auto func) { visit(problem.m_objective.expression, 0, func); }, m_objective_starts, m_objective_entries);
+
+    m_activities.resize(constraint_count);
+    m_positions.assign(constraint_count, NotViolated);
+    refresh();
+  }
+
+  double ActivityTracker::value(VariableId variable) const
+  {
+    assert(to_index(variable) < m_values.size());
+    return m_values[to_index(variable)];
+  }
+
+  void ActivityTracker::set_value(VariableId variable, double value)
+  {
+    const std::size_t index = to_index(variable);
+    assert(index < m_values.size());
+
+    const double change = value - m_values[index];
+
+    if (change == 0.0) {
+      return;
+    }
+
+    for (std::size_t k = m_column_starts[index]; k < m_column_starts[index + 1]; ++k) {
+      const Entry& entry = m_entries[k];
+      m_activities[entry.row] += delta(entry, index, change);
+    }
+
+    m_objective_value += objective_delta(variable, value);
+    m_values[index] = value;
+
+    for (std::size_t k = m_column_starts[index]; k < m_column_starts[index + 1]; ++k) {
+      update_violation(m_entries[k].row);
+    }
+  }
+
+  void ActivityTracker::flip(VariableId variable)
+  {
+    set_value(variable, 1.0 - value(variable));
+  }
+
+  double ActivityTracker::objective_delta(VariableId variable, double value) const
+  {
+    const std::size_t index = to_index(variable);
+    assert(index < m_values.size());
+
+    const double change = value - m_values[index];
+    double result = 0.0;
+
+    for (std::size_t k = m_objective_starts[index]; k < m_objective_starts[index + 1]; ++k) {
+      result += delta(m_objective_entries[k], index, change);
+    }
+
+    return result;
+  }
+
+  double ActivityTracker::activity(ConstraintId constraint) const
+  {
+    assert(constraint.index < m_activities.size());
+    return m_activities[constraint.index];
+  }
+
+  bool ActivityTracker::is_violated(ConstraintId constraint) const
+  {
+    assert(constraint.index < m_positions.size());
+    return m_positions[constraint.index] != NotViolated;
+  }
+
+  const std::vector<std::size_t>& ActivityTracker::violated_constraints() const
+  {
+    return m_violated;
+  }
+
+  std::size_t ActivityTracker::violated_constraint_count() const
+  {
+    return m_violated.size();
+  }
+
+  bool ActivityTracker::feasible() const
+  {
+    return m_violated.empty();
+  }
+
+  double ActivityTracker::objective_value() const
+  {
+    return m_objective_value;
+  }
+
+  void ActivityTracker::refresh()
+  {
+    const Solution solution = this->solution();
+
+    for (std::size_t row = 0; row < m_activities.size(); ++row) {
+      const QExpr& expression = m_problem->m_constraints[row].expression;
+      m_activities[row] = expression.evaluate(solution) - expression.constant();
+      update_violation(row);
+    }
+
+    m_objective_value = m_problem->m_objective.expression.evaluate(solution);
+  }
+
+  Solution ActivityTracker::solution() const
+  {
+    return { SolutionStatus::Undefined, m_values };
+  }
+
+  // change of the term when the variable changes, the other variable of a
+  // quadratic term has its current value
+  double ActivityTracker::delta(const Entry& entry, std::size_t variable, double change) const
+  {
+    if (entry.other == NoVariable) {
+      return entry.coefficient * change;
+    }
+
+    if (entry.other == variable) {
+      return entry.coefficient * change * (2.0 * m_values[variable] + change);
+    }
+
+    return entry.coefficient * change * m_values[entry.other];
+  }
+
+  void ActivityTracker::update_violation(std::size_t row)
+  {
+    const auto& constraint = m_problem->m_constraints[row];
+    const bool violated = constraint.range.distance(m_activities[row] + constraint.expression.constant()) > m_tolerance;
+    std::size_t& position = m_positions[row];
+
+    if (violated && position == NotViolated) {
+      position = m_violated.size();
+      m_violated.push_back(row);
+    } else if (!violated && position != NotViolated) {
+      // swap with the last one
+      const std::size_t last = m_violated.back();
+      m_violated[position] = last;
+      m_positions[last] = position;
+      m_violated.pop_back();
+      position = NotViolated;
+    }
+  }
+
+}
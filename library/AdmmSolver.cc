@@ -0,0 +1,853 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include <lqp/AdmmSolver.h>
+// clang-format on
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include <lqp/Problem.h>
+
+namespace lqp {
+
+  namespace {
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+
+    constexpr double Sigma = 1e-6;
+    constexpr double Alpha = 1.6;
+    constexpr double InitialRho = 0.1;
+    constexpr double MinimumRho = 1e-6;
+    constexpr double MaximumRho = 1e6;
+    constexpr double EqualityRhoFactor = 1e3;
+    constexpr double RhoAdaptationRatio = 5.0;
+
+    constexpr double AbsoluteTolerance = 1e-5;
+    constexpr double RelativeTolerance = 1e-5;
+    constexpr double InfeasibilityTolerance = 1e-5;
+
+    constexpr std::size_t ScalingIterations = 10;
+    constexpr double MinimumScaling = 1e-4;
+    constexpr double MaximumScaling = 1e4;
+
+    constexpr std::size_t IterationLimit = 100000;
+    constexpr std::size_t CheckPeriod = 10;
+    constexpr std::size_t RhoUpdatePeriod = 50;
+    constexpr std::size_t ProgressPeriod = 1000;
+
+    constexpr double MinimumConjugateGradientTolerance = 1e-10;
+    constexpr double ConjugateGradientReferenceRho = 1e-2;
+    constexpr std::size_t MaximumConjugateGradientIterations = 500;
+
+    double infinity_norm(const std::vector<double>& values)
+    {
+      double norm = 0.0;
+
+      for (const double value : values) {
+        norm = std::max(norm, std::abs(value));
+      }
+
+      return norm;
+    }
+
+    double dot(const std::vector<double>& lhs, const std::vector<double>& rhs)
+    {
+      assert(lhs.size() == rhs.size());
+      double result = 0.0;
+
+      for (std::size_t i = 0; i < lhs.size(); ++i) {
+        result += lhs[i] * rhs[i];
+      }
+
+      return result;
+    }
+
+    double clamp_scaling(double norm)
+    {
+      if (norm < MinimumScaling) {
+        return 1.0;
+      }
+
+      return std::min(norm, MaximumScaling);
+    }
+
+    // sparse matrix in compressed sparse row format
+    struct SparseRows {
+      std::vector<std::size_t> starts = { 0 };
+      std::vector<uint32_t> indices;
+      std::vector<double> values;
+
+      std::size_t row_count() const
+      {
+        return starts.size() - 1;
+      }
+
+      // result = M x
+      void multiply(const std::vector<double>& x, std::vector<double>& result) const
+      {
+        result.resize(row_count());
+
+        for (std::size_t i = 0; i < row_count(); ++i) {
+          double sum = 0.0;
+
+          for (std::size_t p = starts[i]; p < starts[i + 1]; ++p) {
+            sum += values[p] * x[indices[p]];
+          }
+
+          result[i] = sum;
+        }
+      }
+
+      // result = M^T x
+      void multiply_transposed(const std::vector<double>& x, std::vector<double>& result, std::size_t column_count) const
+      {
+        result.assign(column_count, 0.0);
+
+        for (std::size_t i = 0; i < row_count(); ++i) {
+          if (x[i] == 0.0) {
+            continue;
+          }
+
+          for (std::size_t p = starts[i]; p < starts[i + 1]; ++p) {
+            result[indices[p]] += values[p] * x[i];
+          }
+        }
+      }
+    };
+
+    struct AdmmOptions {
+      std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+      const std::atomic<bool>* stop = nullptr;
+      bool verbose = false;
+    };
+
+    // Solves min 1/2 x^T P x + q^T x subject to l <= A x <= u where the rows
+    // of A are the constraints followed by the variables that have a finite
+    // bound. The problem is scaled with a Ruiz equilibration: P is replaced
+    // with c D P D, q with c D q, A with E A D, and l, u with E l, E u.
+    // Without the objective, P and q are zero and only the feasibility of
+    // the constraints is solved.
+    class AdmmEngine {
+    public:
+      explicit AdmmEngine(const CompiledProblem& problem, bool with_objective = true);
+
+      SolutionStatus solve(const AdmmOptions& options);
+      std::vector<double> primal_values() const;
+
+    private:
+      struct Residuals {
+        double primal;
+        double primal_tolerance;
+        double dual;
+        double dual_tolerance;
+        double scaled_primal;
+        double scaled_dual;
+        double gap;
+        double gap_tolerance;
+      };
+
+      void scale();
+      void set_rho(double rho);
+      void multiply_system(const std::vector<double>& x, std::vector<double>& result);
+      void conjugate_gradient(const std::vector<double>& rhs, std::vector<double>& x, double tolerance);
+
+      Residuals compute_residuals();
+      bool is_primal_infeasible();
+      bool is_dual_infeasible();
+      double objective_value();
+
+      std::size_t m_variable_count = 0;
+      std::size_t m_row_count = 0;
+
+      double m_sign = 1.0;
+      double m_objective_constant = 0.0;
+      std::vector<double> m_variable_lower_bounds;
+      std::vector<double> m_variable_upper_bounds;
+
+      SparseRows m_quadratic; // P, symmetric with both triangles
+      SparseRows m_rows;      // A
+      std::vector<double> m_linear;
+      std::vector<double> m_lower;
+      std::vector<double> m_upper;
+
+      double m_cost_scaling = 1.0;
+      std::vector<double> m_variable_scaling;
+      std::vector<double> m_row_scaling;
+
+      double m_rho = InitialRho;
+      std::vector<double> m_row_rho;
+      std::vector<double> m_preconditioner;
+
+      std::vector<double> m_x;
+      std::vector<double> m_z;
+      std::vector<double> m_y;
+      std::vector<double> m_delta_x;
+      std::vector<double> m_delta_y;
+
+      // work data
+      std::vector<double> m_x_tilde;
+      std::vector<double> m_z_tilde;
+      std::vector<double> m_rhs;
+      std::vector<double> m_column_work[4];
+      std::vector<double> m_row_work[2];
+    };
+
+    AdmmEngine::AdmmEngine(const CompiledProblem& problem, bool with_objective)
+    : m_variable_count(problem.variable_count())
+    , m_sign(problem.sense() == Sense::Maximize ? -1.0 : 1.0)
+    , m_objective_constant(problem.objective_constant())
+    , m_variable_lower_bounds(problem.variable_lower_bounds())
+    , m_variable_upper_bounds(problem.variable_upper_bounds())
+    {
+      const std::size_t n = m_variable_count;
+
+      // P from the triplets, a term q x_i x_j contributes q to P_ij and P_ji
+      // and a term q x_i^2 contributes 2 q to P_ii
+
+      const std::vector<uint32_t> no_indices;
+      const std::vector<double> no_values;
+      const auto& quadratic_rows = with_objective ? problem.quadratic_rows() : no_indices;
+      const auto& quadratic_columns = with_objective ? problem.quadratic_columns() : no_indices;
+      const auto& quadratic_values = with_objective ? problem.quadratic_values() : no_values;
+
+      std::vector<std::size_t> counts(n + 1, 0);
+
+      for (std::size_t k = 0; k < quadratic_values.size(); ++k) {
+        ++counts[quadratic_rows[k] + 1];
+
+        if (quadratic_rows[k] != quadratic_columns[k]) {
+          ++counts[quadratic_columns[k] + 1];
+        }
+      }
+
+      for (std::size_t j = 0; j < n; ++j) {
+        counts[j + 1] += counts[j];
+      }
+
+      m_quadratic.starts = counts;
+      m_quadratic.indices.resize(counts[n]);
+      m_quadratic.values.resize(counts[n]);
+
+      for (std::size_t k = 0; k < quadratic_values.size(); ++k) {
+        const uint32_t i = quadratic_rows[k];
+        const uint32_t j = quadratic_columns[k];
+        const double value = m_sign * quadratic_values[k];
+
+        if (i == j) {
+          m_quadratic.indices[counts[i]] = i;
+          m_quadratic.values[counts[i]++] = 2.0 * value;
+        } else {
+          m_quadratic.indices[counts[i]] = j;
+          m_quadratic.values[counts[i]++] = value;
+          m_quadratic.indices[counts[j]] = i;
+          m_quadratic.values[counts[j]++] = value;
+        }
+      }
+
+      m_linear = problem.objective();
+
+      if (!with_objective) {
+        std::fill(m_linear.begin(), m_linear.end(), 0.0);
+      }
+
+      for (double& value : m_linear) {
+        value *= m_sign;
+      }
+
+      // A with the constraints followed by the bounded variables
+
+      m_rows.starts = problem.row_starts();
+      m_rows.indices = problem.column_indices();
+      m_rows.values = problem.values();
+      m_lower = problem.constraint_lower_bounds();
+      m_upper = problem.constraint_upper_bounds();
+
+      for (std::size_t j = 0; j < n; ++j) {
+        if (m_variable_lower_bounds[j] == -Infinity && m_variable_upper_bounds[j] == Infinity) {
+          continue;
+        }
+
+        m_rows.indices.push_back(static_cast<uint32_t>(j));
+        m_rows.values.push_back(1.0);
+        m_rows.starts.push_back(m_rows.indices.size());
+        m_lower.push_back(m_variable_lower_bounds[j]);
+        m_upper.push_back(m_variable_upper_bounds[j]);
+      }
+
+      m_row_count = m_rows.row_count();
+
+      scale();
+
+      m_x.assign(n, 0.0);
+      m_z.assign(m_row_count, 0.0);
+      m_y.assign(m_row_count, 0.0);
+      m_delta_x.assign(n, 0.0);
+      m_delta_y.assign(m_row_count, 0.0);
+      m_x_tilde.assign(n, 0.0);
+      m_z_tilde.assign(m_row_count, 0.0);
+
+      set_rho(InitialRho);
+    }
+
+    void AdmmEngine::scale()
+    {
+      const std::size_t n = m_variable_count;
+
+      m_variable_scaling.assign(n, 1.0);
+      m_row_scaling.assign(m_row_count, 1.0);
+
+      std::vector<double> variable_factors(n);
+      std::vector<double> row_factors(m_row_count);
+
+      for (std::size_t iteration = 0; iteration < ScalingIterations; ++iteration) {
+        // infinity norms of the columns of [ P A^T ; A 0 ]
+        std::fill(variable_factors.begin(), variable_factors.end(), 0.0);
+        std::fill(row_factors.begin(), row_factors.end(), 0.0);
+
+        for (std::size_t j = 0; j < n; ++j) {
+          for (std::size_t p = m_quadratic.starts[j]; p < m_quadratic.starts[j + 1]; ++p) {
+            variable_factors[j] = std::max(variable_factors[j], std::abs(m_quadratic.values[p]));
+          }
+        }
+
+        for (std::size_t i = 0; i < m_row_count; ++i) {
+          for (std::size_t p = m_rows.starts[i]; p < m_rows.starts[i + 1]; ++p) {
+            const double magnitude = std::abs(m_rows.values[p]);
+            variable_factors[m_rows.indices[p]] = std::max(variable_factors[m_rows.indices[p]], magnitude);
+            row_factors[i] = std::max(row_factors[i], magnitude);
+          }
+        }
+
+        for (double& factor : variable_factors) {
+          factor = 1.0 / std::sqrt(clamp_scaling(factor));
+        }
+
+        for (double& factor : row_factors) {
+          factor = 1.0 / std::sqrt(clamp_scaling(factor));
+        }
+
+        for (std::size_t j = 0; j < n; ++j) {
+          for (std::size_t p = m_quadratic.starts[j]; p < m_quadratic.starts[j + 1]; ++p) {
+            m_quadratic.values[p] *= variable_factors[j] * variable_factors[m_quadratic.indices[p]];
+          }
+
+          m_variable_scaling[j] *= variable_factors[j];
+        }
+
+        for (std::size_t i = 0; i < m_row_count; ++i) {
+          for (std::size_t p = m_rows.starts[i]; p < m_rows.starts[i + 1]; ++p) {
+            m_rows.values[p] *= row_factors[i] * variable_factors[m_rows.indices[p]];
+          }
+
+          m_row_scaling[i] *= row_factors[i];
+        }
+      }
+
+      for (std::size_t j = 0; j < n; ++j) {
+        m_linear[j] *= m_variable_scaling[j];
+      }
+
+      // cost scaling, from the mean of the column norms of P and the norm of q
+
+      double quadratic_norm = 0.0;
+
+      for (std::size_t j = 0; j < n; ++j) {
+        double column_norm = 0.0;
+
+        for (std::size_t p = m_quadratic.starts[j]; p < m_quadratic.starts[j + 1]; ++p) {
+          column_norm = std::max(column_norm, std::abs(m_quadratic.values[p]));
+        }
+
+        quadratic_norm += column_norm;
+      }
+
+      if (n > 0) {
+        quadratic_norm /= double(n);
+      }
+
+      m_cost_scaling = 1.0 / clamp_scaling(std::max(quadratic_norm, infinity_norm(m_linear)));
+
+      for (double& value : m_quadratic.values) {
+        value *= m_cost_scaling;
+      }
+
+      for (double& value : m_linear) {
+        value *= m_cost_scaling;
+      }
+
+      for (std::size_t i = 0; i < m_row_count; ++i) {
+        m_lower[i] *= m_row_scaling[i];
+        m_upper[i] *= m_row_scaling[i];
+      }
+    }
+
+    // the equality rows get a larger step and the free rows a minimal one
+    void AdmmEngine::set_rho(double rho)
+    {
+      m_rho = std::clamp(rho, MinimumRho, MaximumRho);
+      m_row_rho.resize(m_row_count);
+
+      for (std::size_t i = 0; i < m_row_count; ++i) {
+        if (m_lower[i] == -Infinity && m_upper[i] == Infinity) {
+          m_row_rho[i] = MinimumRho;
+        } else if (m_upper[i] - m_lower[i] < 1e-4) {
+          m_row_rho[i] = EqualityRhoFactor * m_rho;
+        } else {
+          m_row_rho[i] = m_rho;
+        }
+      }
+
+      // Jacobi preconditioner: the diagonal of P + sigma I + A^T R A
+      m_preconditioner.assign(m_variable_count, Sigma);
+
+      for (std::size_t j = 0; j < m_variable_count; ++j) {
+        for (std::size_t p = m_quadratic.starts[j]; p < m_quadratic.starts[j + 1]; ++p) {
+          if (m_quadratic.indices[p] == j) {
+            m_preconditioner[j] += m_quadratic.values[p];
+          }
+        }
+      }
+
+      for (std::size_t i = 0; i < m_row_count; ++i) {
+        for (std::size_t p = m_rows.starts[i]; p < m_rows.starts[i + 1]; ++p) {
+          m_preconditioner[m_rows.indices[p]] += m_row_rho[i] * m_rows.values[p] * m_rows.values[p];
+        }
+      }
+
+      for (double& value : m_preconditioner) {
+        value = value > 0.0 ? 1.0 / value : 1.0;
+      }
+    }
+
+    // result = (P + sigma I + A^T R A) x
+    void AdmmEngine::multiply_system(const std::vector<double>& x, std::vector<double>& result)
+    {
+      std::vector<double>& ax = m_row_work[1];
+      std::vector<double>& atax = m_column_work[3];
+
+      m_quadratic.multiply(x, result);
+      m_rows.multiply(x, ax);
+
+      for (std::size_t i = 0; i < m_row_count; ++i) {
+        ax[i] *= m_row_rho[i];
+      }
+
+      m_rows.multiply_transposed(ax, atax, m_variable_count);
+
+      for (std::size_t j = 0; j < m_variable_count; ++j) {
+        result[j] += Sigma * x[j] + atax[j];
+      }
+    }
+
+    // x is the starting point and the result, the residual is measured with
+    // the infinity norm
+    void AdmmEngine::conjugate_gradient(const std::vector<double>& rhs, std::vector<double>& x, double tolerance)
+    {
+      const std::size_t n = m_variable_count;
+      std::vector<double>& residual = m_column_work[0];
+      std::vector<double>& direction = m_column_work[1];
+      std::vector<double>& product = m_column_work[2];
+
+      multiply_system(x, product);
+      residual.resize(n);
+
+      for (std::size_t j = 0; j < n; ++j) {
+        residual[j] = rhs[j] - product[j];
+      }
+
+      if (infinity_norm(residual) <= tolerance) {
+        return;
+      }
+
+      direction.resize(n);
+
+      for (std::size_t j = 0; j < n; ++j) {
+        direction[j] = m_preconditioner[j] * residual[j];
+      }
+
+      double residual_product = dot(residual, direction);
+      const std::size_t iteration_limit = std::min(n + 1, MaximumConjugateGradientIterations);
+
+      for (std::size_t iteration = 0; iteration < iteration_limit; ++iteration) {
+        multiply_system(direction, product);
+        const double curvature = dot(direction, product);
+
+        if (curvature <= 0.0) {
+          break;
+        }
+
+        const double step = residual_product / curvature;
+
+        for (std::size_t j = 0; j < n; ++j) {
+          x[j] += step * direction[j];
+          residual[j] -= step * product[j];
+        }
+
+        if (infinity_norm(residual) <= tolerance) {
+          break;
+        }
+
+        double next_residual_product = 0.0;
+
+        for (std::size_t j = 0; j < n; ++j) {
+          next_residual_product += residual[j] * m_preconditioner[j] * residual[j];
+        }
+
+        const double beta = next_residual_product / residual_product;
+        residual_product = next_residual_product;
+
+        for (std::size_t j = 0; j < n; ++j) {
+          direction[j] = m_preconditioner[j] * residual[j] + beta * direction[j];
+        }
+      }
+    }
+
+    SolutionStatus AdmmEngine::solve(const AdmmOptions& options)
+    {
+      const std::size_t n = m_variable_count;
+      std::vector<double>& work = m_row_work[0];
+      double tolerance = 1e-3;
+
+      m_rhs.resize(n);
+      work.resize(m_row_count);
+
+      for (std::size_t iteration = 1; iteration <= IterationLimit; ++iteration) {
+        // (P + sigma I + A^T R A) x~ = sigma x - q + A^T (R z - y)
+
+        for (std::size_t i = 0; i < m_row_count; ++i) {
+          work[i] = m_row_rho[i] * m_z[i] - m_y[i];
+        }
+
+        m_rows.multiply_transposed(work, m_rhs, n);
+
+        for (std::size_t j = 0; j < n; ++j) {
+          m_rhs[j] += Sigma * m_x[j] - m_linear[j];
+        }
+
+        conjugate_gradient(m_rhs, m_x_tilde, tolerance);
+        m_rows.multiply(m_x_tilde, m_z_tilde);
+
+        // relaxed updates
+
+        for (std::size_t j = 0; j < n; ++j) {
+          const double x = Alpha * m_x_tilde[j] + (1.0 - Alpha) * m_x[j];
+          m_delta_x[j] = x - m_x[j];
+          m_x[j] = x;
+        }
+
+        for (std::size_t i = 0; i < m_row_count; ++i) {
+          const double z_hat = Alpha * m_z_tilde[i] + (1.0 - Alpha) * m_z[i];
+          const double z = std::clamp(z_hat + m_y[i] / m_row_rho[i], m_lower[i], m_upper[i]);
+          const double y = m_y[i] + m_row_rho[i] * (z_hat - z);
+          m_delta_y[i] = y - m_y[i];
+          m_y[i] = y;
+          m_z[i] = z;
+        }
+
+        if (iteration % CheckPeriod != 0) {
+          continue;
+        }
+
+        const Residuals residuals = compute_residuals();
+
+        if (options.verbose && iteration % ProgressPeriod == 0) {
+          std::printf("%8zu: obj = %17.9e prim = %11.3e dual = %11.3e rho = %9.2e\n", iteration, objective_value(), residuals.primal, residuals.dual, m_rho);
+        }
+
+        // the residuals relative to the norms of the iterates are not enough
+        // for an accurate solution, the residuals of the scaled problem and
+        // the duality gap bound the violations and the objective error
+        if (residuals.scaled_primal <= AbsoluteTolerance && residuals.scaled_dual <= AbsoluteTolerance && residuals.gap <= residuals.gap_tolerance) {
+          if (options.verbose) {
+            std::printf("%8zu: obj = %17.9e prim = %11.3e dual = %11.3e\n", iteration, objective_value(), residuals.primal, residuals.dual);
+          }
+
+          return SolutionStatus::Optimal;
+        }
+
+        if (is_primal_infeasible()) {
+          return SolutionStatus::NoFeasibleSolution;
+        }
+
+        if (is_dual_infeasible()) {
+          return SolutionStatus::UnboundedSolution;
+        }
+
+        if (options.stop != nullptr && options.stop->load(std::memory_order_relaxed)) {
+          break;
+        }
+
+        if (options.deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= options.deadline) {
+          break;
+        }
+
+        // with a small rho, the system of an LP is almost singular and the
+        // errors of the solves would hide the infeasibility certificates
+        tolerance = 0.15 * std::min(residuals.scaled_primal, residuals.scaled_dual) * std::min(1.0, m_rho / ConjugateGradientReferenceRho);
+        tolerance = std::max(tolerance, MinimumConjugateGradientTolerance);
+
+        if (iteration % RhoUpdatePeriod == 0) {
+          const double primal_ratio = residuals.primal / std::max(residuals.primal_tolerance - AbsoluteTolerance, 1e-10);
+          const double dual_ratio = residuals.dual / std::max(residuals.dual_tolerance - AbsoluteTolerance, 1e-10);
+          const double ratio = std::sqrt(primal_ratio / std::max(dual_ratio, 1e-10));
+
+          if (ratio > RhoAdaptationRatio || ratio < 1.0 / RhoAdaptationRatio) {
+            set_rho(m_rho * ratio);
+          }
+        }
+      }
+
+      // the residuals are relative to the iterates, they can not tell a
+      // feasible point from diverging iterates
+      return SolutionStatus::Undefined;
+    }
+
+    std::vector<double> AdmmEngine::primal_values() const
+    {
+      std::vector<double> values(m_variable_count);
+
+      for (std::size_t j = 0; j < m_variable_count; ++j) {
+        values[j] = m_variable_scaling[j] * m_x[j];
+      }
+
+      return values;
+    }
+
+    // the residuals and their tolerances are measured on the unscaled problem
+    AdmmEngine::Residuals AdmmEngine::compute_residuals()
+    {
+      std::vector<double>& ax = m_row_work[1];
+      std::vector<double>& px = m_column_work[0];
+      std::vector<double>& aty = m_column_work[1];
+
+      m_rows.multiply(m_x, ax);
+      m_quadratic.multiply(m_x, px);
+      m_rows.multiply_transposed(m_y, aty, m_variable_count);
+
+      Residuals residuals = {};
+      double ax_norm = 0.0;
+      double z_norm = 0.0;
+
+      for (std::size_t i = 0; i < m_row_count; ++i) {
+        const double difference = ax[i] - m_z[i];
+        residuals.primal = std::max(residuals.primal, std::abs(difference / m_row_scaling[i]));
+        residuals.scaled_primal = std::max(residuals.scaled_primal, std::abs(difference));
+        ax_norm = std::max(ax_norm, std::abs(ax[i] / m_row_scaling[i]));
+        z_norm = std::max(z_norm, std::abs(m_z[i] / m_row_scaling[i]));
+      }
+
+      double px_norm = 0.0;
+      double aty_norm = 0.0;
+      double q_norm = 0.0;
+
+      for (std::size_t j = 0; j < m_variable_count; ++j) {
+        const double difference = px[j] + m_linear[j] + aty[j];
+        residuals.dual = std::max(residuals.dual, std::abs(difference / m_variable_scaling[j]));
+        residuals.scaled_dual = std::max(residuals.scaled_dual, std::abs(difference));
+        px_norm = std::max(px_norm, std::abs(px[j] / m_variable_scaling[j]));
+        aty_norm = std::max(aty_norm, std::abs(aty[j] / m_variable_scaling[j]));
+        q_norm = std::max(q_norm, std::abs(m_linear[j] / m_variable_scaling[j]));
+      }
+
+      residuals.dual /= m_cost_scaling;
+      residuals.primal_tolerance = AbsoluteTolerance + RelativeTolerance * std::max(ax_norm, z_norm);
+      residuals.dual_tolerance = AbsoluteTolerance + RelativeTolerance * std::max({ px_norm, aty_norm, q_norm }) / m_cost_scaling;
+
+      // duality gap, the dual objective is -1/2 x^T P x - u^T max(y, 0) -
+      // l^T min(y, 0) when the dual residual is zero
+      const double quadratic = dot(m_x, px);
+      const double primal_objective = 0.5 * quadratic + dot(m_linear, m_x);
+      double support = 0.0;
+
+      for (std::size_t i = 0; i < m_row_count; ++i) {
+        if (m_y[i] > 0.0 && m_upper[i] != Infinity) {
+          support += m_upper[i] * m_y[i];
+        } else if (m_y[i] < 0.0 && m_lower[i] != -Infinity) {
+          support += m_lower[i] * m_y[i];
+        }
+      }
+
+      const double dual_objective = -0.5 * quadratic - support;
+      residuals.gap = std::abs(primal_objective - dual_objective) / m_cost_scaling;
+      residuals.gap_tolerance = AbsoluteTolerance + RelativeTolerance * std::max(std::abs(primal_objective), std::abs(dual_objective)) / m_cost_scaling;
+      return residuals;
+    }
+
+    // delta y is a certificate if A^T dy = 0 and u^T max(dy, 0) + l^T min(dy, 0) < 0
+    bool AdmmEngine::is_primal_infeasible()
+    {
+      double norm = 0.0;
+
+      for (std::size_t i = 0; i < m_row_count; ++i) {
+        norm = std::max(norm, std::abs(m_row_scaling[i] * m_delta_y[i]));
+      }
+
+      if (norm == 0.0) {
+        return false;
+      }
+
+      const double threshold = InfeasibilityTolerance * norm;
+      double support = 0.0;
+
+      for (std::size_t i = 0; i < m_row_count; ++i) {
+        const double delta = m_delta_y[i];
+
+        if (delta > 0.0) {
+          if (m_upper[i] == Infinity) {
+            if (m_row_scaling[i] * delta > threshold) {
+              return false;
+            }
+          } else {
+            support += m_upper[i] * delta;
+          }
+        } else if (delta < 0.0) {
+          if (m_lower[i] == -Infinity) {
+            if (-m_row_scaling[i] * delta > threshold) {
+              return false;
+            }
+          } else {
+            support += m_lower[i] * delta;
+          }
+        }
+      }
+
+      if (support >= -threshold) {
+        return false;
+      }
+
+      std::vector<double>& atdy = m_column_work[0];
+      m_rows.multiply_transposed(m_delta_y, atdy, m_variable_count);
+
+      for (std::size_t j = 0; j < m_variable_count; ++j) {
+        if (std::abs(atdy[j] / m_variable_scaling[j]) > threshold) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    // delta x is a certificate if P dx = 0, q^T dx < 0 and A dx is in the
+    // recession cone of the bounds
+    bool AdmmEngine::is_dual_infeasible()
+    {
+      double norm = 0.0;
+
+      for (std::size_t j = 0; j < m_variable_count; ++j) {
+        norm = std::max(norm, std::abs(m_variable_scaling[j] * m_delta_x[j]));
+      }
+
+      if (norm == 0.0) {
+        return false;
+      }
+
+      const double threshold = InfeasibilityTolerance * norm;
+
+      if (dot(m_linear, m_delta_x) >= -m_cost_scaling * threshold) {
+        return false;
+      }
+
+      std::vector<double>& pdx = m_column_work[0];
+      m_quadratic.multiply(m_delta_x, pdx);
+
+      for (std::size_t j = 0; j < m_variable_count; ++j) {
+        if (std::abs(pdx[j] / m_variable_scaling[j]) > m_cost_scaling * threshold) {
+          return false;
+        }
+      }
+
+      std::vector<double>& adx = m_row_work[1];
+      m_rows.multiply(m_delta_x, adx);
+
+      for (std::size_t i = 0; i < m_row_count; ++i) {
+        const double value = adx[i] / m_row_scaling[i];
+
+        if (m_upper[i] != Infinity && value > threshold) {
+          return false;
+        }
+
+        if (m_lower[i] != -Infinity && value < -threshold) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    double AdmmEngine::objective_value()
+    {
+      std::vector<double>& px = m_column_work[0];
+      m_quadratic.multiply(m_x, px);
+      const double value = 0.5 * dot(m_x, px) + dot(m_linear, m_x);
+      return m_sign * value / m_cost_scaling + m_objective_constant;
+    }
+
+  }
+
+  bool AdmmSolver::available() const
+  {
+    return true;
+  }
+
+  Solution AdmmSolver::solve(const Problem& problem, const SolverConfig& config)
+  {
+    const auto compiled = problem.compile();
+
+    if (!compiled) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    return solve(*compiled, config);
+  }
+
+  Solution AdmmSolver::solve(const CompiledProblem& problem, const SolverConfig& config)
+  {
+    const auto& categories = problem.variable_categories();
+
+    if (config.use_mip && std::any_of(categories.begin(), categories.end(), [](VariableCategory category) { return category != VariableCategory::Continuous; })) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    AdmmEngine engine(problem);
+
+    AdmmOptions options;
+    options.verbose = config.verbose;
+    options.stop = config.stop;
+
+    if (config.timeout != std::chrono::milliseconds::max()) {
+      options.deadline = std::chrono::steady_clock::now() + config.timeout;
+    }
+
+    SolutionStatus status = engine.solve(options);
+
+    if (status == SolutionStatus::UnboundedSolution) {
+      // the ray proves the unboundedness only if the constraints are
+      // feasible, a problem may be both primal and dual infeasible
+      AdmmEngine feasibility(problem, false);
+
+      switch (feasibility.solve(options)) {
+        case SolutionStatus::Optimal:
+          break;
+        case SolutionStatus::NoFeasibleSolution:
+          status = SolutionStatus::NoFeasibleSolution;
+          break;
+        default:
+          status = SolutionStatus::Undefined;
+          break;
+      }
+    }
+
+    if (status == SolutionStatus::Optimal) {
+      return { status, engine.primal_values() };
+    }
+
+    return { status };
+  }
+
+}
@@ -0,0 +1,430 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include "BasisFactorization.h"
+// clang-format on
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+
+namespace lqp::details {
+  namespace {
+    constexpr std::size_t Unset = std::size_t(-1);
+    constexpr double DropTolerance = 1e-14;
+    constexpr double PivotTolerance = 1e-9;
+    constexpr double PivotThreshold = 0.1;
+
+    // orders the columns of the basis: first the columns found by
+    // eliminating the row singletons, that form a triangular part without
+    // fill-in, then the remaining columns by increasing number of nonzeros
+    void order_columns(const SparseColumns& basis, std::vector<std::size_t>& order, std::vector<std::size_t>& preferred_rows, std::vector<std::size_t>& row_counts)
+    {
+      const std::size_t size = basis.row_count;
+
+      row_counts.assign(size, 0);
+
+      for (const std::size_t row : basis.indices) {
+        ++row_counts[row];
+      }
+
+      std::vector<std::size_t> row_starts(size + 1, 0);
+
+      for (std::size_t row = 0; row < size; ++row) {
+        row_starts[row + 1] = row_starts[row] + row_counts[row];
+      }
+
+      std::vector<std::size_t> row_columns(basis.indices.size());
+      std::vector<std::size_t> next(row_starts.begin(), row_starts.end() - 1);
+
+      for (std::size_t column = 0; column < size; ++column) {
+        for (std::size_t p = basis.starts[column]; p < basis.starts[column + 1]; ++p) {
+          row_columns[next[basis.indices[p]]++] = column;
+        }
+      }
+
+      std::vector<bool> active(size, true);
+      preferred_rows.assign(size, Unset);
+      order.clear();
+      order.reserve(size);
+
+      std::vector<std::size_t> singletons;
+
+      for (std::size_t row = 0; row < size; ++row) {
+        if (row_counts[row] == 1) {
+          singletons.push_back(row);
+        }
+      }
+
+      while (!singletons.empty()) {
+        const std::size_t row = singletons.back();
+        singletons.pop_back();
+
+        if (row_counts[row] != 1) {
+          continue;
+        }
+
+        const auto iterator = std::find_if(row_columns.begin() + static_cast<std::ptrdiff_t>(row_starts[row]), row_columns.begin() + static_cast<std::ptrdiff_t>(row_starts[row + 1]), [&](std::size_t column) {
+          return active[column];
+        });
+        assert(iterator != row_columns.begin() + static_cast<std::ptrdiff_t>(row_starts[row + 1]));
+
+        const std::size_t column = *iterator;
+        active[column] = false;
+        order.push_back(column);
+        preferred_rows[column] = row;
+
+        for (std::size_t p = basis.starts[column]; p < basis.starts[column + 1]; ++p) {
+          if (--row_counts[basis.indices[p]] == 1) {
+            singletons.push_back(basis.indices[p]);
+          }
+        }
+      }
+
+      const std::size_t triangular_size = order.size();
+
+      for (std::size_t column = 0; column < size; ++column) {
+        if (active[column]) {
+          order.push_back(column);
+        }
+      }
+
+      std::stable_sort(order.begin() + static_cast<std::ptrdiff_t>(triangular_size), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+        return basis.starts[lhs + 1] - basis.starts[lhs] < basis.starts[rhs + 1] - basis.starts[rhs];
+      });
+    }
+  }
+
+  std::vector<std::pair<std::size_t, std::size_t>> BasisFactorization::factorize(const SparseColumns& basis)
+  {
+    assert(basis.column_count() == basis.row_count);
+    const std::size_t size = basis.row_count;
+    m_size = size;
+
+    m_lower.clear(size);
+    m_upper.clear(size);
+    m_row_steps.assign(size, Unset);
+    m_step_rows.clear();
+    m_step_positions.clear();
+
+    m_etas.clear();
+    m_eta_indices.clear();
+    m_eta_values.clear();
+
+    m_work.assign(size, 0.0);
+    m_pattern.resize(size);
+    m_stack.resize(2 * size);
+    m_marked.assign(size, false);
+
+    std::vector<std::size_t> order;
+    std::vector<std::size_t> preferred_rows;
+    std::vector<std::size_t> row_counts;
+    order_columns(basis, order, preferred_rows, row_counts);
+
+    std::vector<std::size_t> singular_positions;
+
+    for (const std::size_t position : order) {
+      // x = L \ B(:, position)
+      const std::size_t top = reach(position, basis);
+
+      for (std::size_t p = basis.starts[position]; p < basis.starts[position + 1]; ++p) {
+        m_work[basis.indices[p]] = basis.values[p];
+      }
+
+      for (std::size_t k = top; k < size; ++k) {
+        const std::size_t row = m_pattern[k];
+        const std::size_t step = m_row_steps[row];
+
+        if (step == Unset) {
+          continue;
+        }
+
+        const double value = m_work[row];
+
+        if (value == 0.0) {
+          continue;
+        }
+
+        for (std::size_t p = m_lower.starts[step] + 1; p < m_lower.starts[step + 1]; ++p) {
+          m_work[m_lower.indices[p]] -= m_lower.values[p] * value;
+        }
+      }
+
+      // threshold pivoting on the rows without pivot, the sparsest row is
+      // chosen among the rows with a large enough value
+      double pivot_magnitude = 0.0;
+
+      for (std::size_t k = top; k < size; ++k) {
+        const std::size_t row = m_pattern[k];
+
+        if (m_row_steps[row] == Unset) {
+          pivot_magnitude = std::max(pivot_magnitude, std::abs(m_work[row]));
+        }
+      }
+
+      const double threshold = PivotThreshold * pivot_magnitude;
+      std::size_t pivot_row = Unset;
+
+      if (const std::size_t preferred_row = preferred_rows[position]; preferred_row != Unset && m_row_steps[preferred_row] == Unset && std::abs(m_work[preferred_row]) >= threshold) {
+        pivot_row = preferred_row;
+      } else {
+        for (std::size_t k = top; k < size; ++k) {
+          const std::size_t row = m_pattern[k];
+
+          if (m_row_steps[row] != Unset || std::abs(m_work[row]) < threshold) {
+            continue;
+          }
+
+          if (pivot_row == Unset || row_counts[row] < row_counts[pivot_row]) {
+            pivot_row = row;
+          }
+        }
+      }
+
+      if (pivot_row == Unset || pivot_magnitude < PivotTolerance) {
+        singular_positions.push_back(position);
+
+        for (std::size_t k = top; k < size; ++k) {
+          m_work[m_pattern[k]] = 0.0;
+        }
+
+        continue;
+      }
+
+      const std::size_t step = m_step_rows.size();
+      const double pivot = m_work[pivot_row];
+
+      m_lower.push(pivot_row, 1.0);
+
+      for (std::size_t k = top; k < size; ++k) {
+        const std::size_t row = m_pattern[k];
+        const double value = m_work[row];
+        m_work[row] = 0.0;
+
+        if (row == pivot_row || std::abs(value) < DropTolerance) {
+          continue;
+        }
+
+        if (m_row_steps[row] == Unset) {
+          m_lower.push(row, value / pivot);
+        } else {
+          m_upper.push(m_row_steps[row], value);
+        }
+      }
+
+      m_upper.push(step, pivot);
+
+      m_lower.finish_column();
+      m_upper.finish_column();
+
+      m_row_steps[pivot_row] = step;
+      m_step_rows.push_back(pivot_row);
+      m_step_positions.push_back(position);
+    }
+
+    std::vector<std::pair<std::size_t, std::size_t>> singularities;
+
+    if (!singular_positions.empty()) {
+      auto position_iterator = singular_positions.begin();
+
+      for (std::size_t row = 0; row < size; ++row) {
+        if (m_row_steps[row] == Unset) {
+          assert(position_iterator != singular_positions.end());
+          singularities.emplace_back(*position_iterator++, row);
+        }
+      }
+
+      return singularities;
+    }
+
+    // from now on, L is indexed by steps
+    for (std::size_t& index : m_lower.indices) {
+      index = m_row_steps[index];
+    }
+
+    return singularities;
+  }
+
+  void BasisFactorization::ftran(std::vector<double>& values) const
+  {
+    assert(values.size() == m_size);
+    std::vector<double> work(m_size);
+
+    for (std::size_t step = 0; step < m_size; ++step) {
+      work[step] = values[m_step_rows[step]];
+    }
+
+    for (std::size_t step = 0; step < m_size; ++step) {
+      const double value = work[step];
+
+      if (value == 0.0) {
+        continue;
+      }
+
+      for (std::size_t p = m_lower.starts[step] + 1; p < m_lower.starts[step + 1]; ++p) {
+        work[m_lower.indices[p]] -= m_lower.values[p] * value;
+      }
+    }
+
+    for (std::size_t step = m_size; step-- > 0;) {
+      const std::size_t diagonal = m_upper.starts[step + 1] - 1;
+      work[step] /= m_upper.values[diagonal];
+      const double value = work[step];
+
+      if (value == 0.0) {
+        continue;
+      }
+
+      for (std::size_t p = m_upper.starts[step]; p < diagonal; ++p) {
+        work[m_upper.indices[p]] -= m_upper.values[p] * value;
+      }
+    }
+
+    for (std::size_t step = 0; step < m_size; ++step) {
+      values[m_step_positions[step]] = work[step];
+    }
+
+    for (const Eta& eta : m_etas) {
+      const double value = values[eta.position] / eta.pivot;
+      values[eta.position] = value;
+
+      if (value == 0.0) {
+        continue;
+      }
+
+      for (std::size_t k = eta.start; k < eta.end; ++k) {
+        values[m_eta_indices[k]] -= m_eta_values[k] * value;
+      }
+    }
+  }
+
+  void BasisFactorization::btran(std::vector<double>& values) const
+  {
+    assert(values.size() == m_size);
+
+    for (auto iterator = m_etas.rbegin(); iterator != m_etas.rend(); ++iterator) {
+      const Eta& eta = *iterator;
+      double value = values[eta.position];
+
+      for (std::size_t k = eta.start; k < eta.end; ++k) {
+        value -= m_eta_values[k] * values[m_eta_indices[k]];
+      }
+
+      values[eta.position] = value / eta.pivot;
+    }
+
+    std::vector<double> work(m_size);
+
+    for (std::size_t step = 0; step < m_size; ++step) {
+      work[step] = values[m_step_positions[step]];
+    }
+
+    for (std::size_t step = 0; step < m_size; ++step) {
+      const std::size_t diagonal = m_upper.starts[step + 1] - 1;
+      double value = work[step];
+
+      for (std::size_t p = m_upper.starts[step]; p < diagonal; ++p) {
+        value -= m_upper.values[p] * work[m_upper.indices[p]];
+      }
+
+      work[step] = value / m_upper.values[diagonal];
+    }
+
+    for (std::size_t step = m_size; step-- > 0;) {
+      double value = work[step];
+
+      for (std::size_t p = m_lower.starts[step] + 1; p < m_lower.starts[step + 1]; ++p) {
+        value -= m_lower.values[p] * work[m_lower.indices[p]];
+      }
+
+      work[step] = value;
+    }
+
+    for (std::size_t step = 0; step < m_size; ++step) {
+      values[m_step_rows[step]] = work[step];
+    }
+  }
+
+  void BasisFactorization::update(std::size_t position, const std::vector<double>& column)
+  {
+    assert(column.size() == m_size);
+    assert(column[position] != 0.0);
+
+    Eta eta;
+    eta.position = position;
+    eta.pivot = column[position];
+    eta.start = m_eta_indices.size();
+
+    for (std::size_t index = 0; index < m_size; ++index) {
+      if (index != position && std::abs(column[index]) >= DropTolerance) {
+        m_eta_indices.push_back(index);
+        m_eta_values.push_back(column[index]);
+      }
+    }
+
+    eta.end = m_eta_indices.size();
+    m_etas.push_back(eta);
+  }
+
+  // computes the rows reached by the column in the graph of L, in
+  // topological order in m_pattern[top, size)
+  std::size_t BasisFactorization::reach(std::size_t column, const SparseColumns& basis)
+  {
+    std::size_t top = m_size;
+    std::size_t* next = m_stack.data() + m_size;
+
+    for (std::size_t p = basis.starts[column]; p < basis.starts[column + 1]; ++p) {
+      if (m_marked[basis.indices[p]]) {
+        continue;
+      }
+
+      std::size_t head = 0;
+      m_stack[0] = basis.indices[p];
+
+      for (;;) {
+        const std::size_t row = m_stack[head];
+        const std::size_t step = m_row_steps[row];
+
+        if (!m_marked[row]) {
+          m_marked[row] = true;
+          next[head] = (step == Unset) ? 0 : m_lower.starts[step] + 1;
+        }
+
+        const std::size_t end = (step == Unset) ? 0 : m_lower.starts[step + 1];
+        bool done = true;
+
+        for (std::size_t q = next[head]; q < end; ++q) {
+          const std::size_t child = m_lower.indices[q];
+
+          if (m_marked[child]) {
+            continue;
+          }
+
+          next[head] = q + 1;
+          m_stack[++head] = child;
+          done = false;
+          break;
+        }
+
+        if (done) {
+          m_pattern[--top] = row;
+
+          if (head == 0) {
+            break;
+          }
+
+          --head;
+        }
+      }
+    }
+
+    for (std::size_t k = top; k < m_size; ++k) {
+      m_marked[m_pattern[k]] = false;
+    }
+
+    return top;
+  }
+
+}
@@ -0,0 +1,101 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_BASIS_FACTORIZATION_H
+#define LQP_BASIS_FACTORIZATION_H
+
+#include <cstddef>
+
+#include <utility>
+#include <vector>
+
+namespace lqp::details {
+
+  // sparse matrix in compressed sparse column format
+  struct SparseColumns {
+    std::size_t row_count = 0;
+    std::vector<std::size_t> starts = { 0 };
+    std::vector<std::size_t> indices;
+    std::vector<double> values;
+
+    std::size_t column_count() const
+    {
+      return starts.size() - 1;
+    }
+
+    void clear(std::size_t rows)
+    {
+      row_count = rows;
+      starts.assign(1, 0);
+      indices.clear();
+      values.clear();
+    }
+
+    void push(std::size_t index, double value)
+    {
+      indices.push_back(index);
+      values.push_back(value);
+    }
+
+    void finish_column()
+    {
+      starts.push_back(indices.size());
+    }
+  };
+
+  // LU factorization of a square basis matrix, computed column by column
+  // with partial pivoting (Gilbert-Peierls), and product form updates when a
+  // column of the basis is replaced. The rows of the basis are the
+  // constraints and its columns are the positions of the basic variables.
+  class BasisFactorization {
+  public:
+    // returns the singular positions of the basis, each one paired with a
+    // row that has no pivot
+    std::vector<std::pair<std::size_t, std::size_t>> factorize(const SparseColumns& basis);
+
+    // solves B x = b, b is indexed by rows and x by positions
+    void ftran(std::vector<double>& values) const;
+    // solves B^T y = c, c is indexed by positions and y by rows
+    void btran(std::vector<double>& values) const;
+
+    // replaces the column at position with a column whose ftran is column
+    void update(std::size_t position, const std::vector<double>& column);
+
+    std::size_t update_count() const
+    {
+      return m_etas.size();
+    }
+
+  private:
+    struct Eta {
+      std::size_t position;
+      double pivot;
+      std::size_t start;
+      std::size_t end;
+    };
+
+    std::size_t reach(std::size_t column, const SparseColumns& basis);
+
+    std::size_t m_size = 0;
+
+    // L is unit lower triangular with its diagonal first, U is upper
+    // triangular with its diagonal last, both indexed by pivot steps
+    SparseColumns m_lower;
+    SparseColumns m_upper;
+    std::vector<std::size_t> m_row_steps;       // row -> step
+    std::vector<std::size_t> m_step_rows;       // step -> row
+    std::vector<std::size_t> m_step_positions;  // step -> position
+
+    std::vector<Eta> m_etas;
+    std::vector<std::size_t> m_eta_indices;
+    std::vector<double> m_eta_values;
+
+    // work data
+    std::vector<double> m_work;
+    std::vector<std::size_t> m_pattern;
+    std::vector<std::size_t> m_stack;
+    std::vector<bool> m_marked;
+  };
+
+}
+
+#endif // LQP_BASIS_FACTORIZATION_H
@@ -0,0 +1,209 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include <lqp/BatchEvaluator.h>
+// clang-format on
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+
+namespace lqp {
+
+  namespace {
+    constexpr std::size_t BlockSize = 256; // candidates processed together
+
+    // out[k] += a * x[k]
+    void add_scaled(double* out, double a, const double* x, std::size_t count)
+    {
+      for (std::size_t k = 0; k < count; ++k) {
+        out[k] += a * x[k];
+      }
+    }
+
+    // out[k] += a * x[k] * y[k]
+    void add_scaled_product(double* out, double a, const double* x, const double* y, std::size_t count)
+    {
+      for (std::size_t k = 0; k < count; ++k) {
+        out[k] += a * x[k] * y[k];
+      }
+    }
+
+    // out[k] = max(out[k], lower - x[k], x[k] - upper)
+    void update_violation(double* out, const double* x, double lower, double upper, std::size_t count)
+    {
+      for (std::size_t k = 0; k < count; ++k) {
+        out[k] = std::max(out[k], std::max(lower - x[k], x[k] - upper));
+      }
+    }
+
+  }
+
+  BatchEvaluator::BatchEvaluator(const CompiledProblem& problem)
+  : m_problem(&problem)
+  , m_variable_count(problem.variable_count())
+  {
+  }
+
+  BatchEvaluator::BatchEvaluator(const Problem& problem)
+  {
+    auto compiled = problem.compile();
+
+    if (!compiled) {
+      return;
+    }
+
+    const Problem::Linearization* linearization = problem.linearization();
+    assert(linearization != nullptr);
+
+    m_variable_count = problem.m_variables.size();
+    m_auxiliaries.resize(linearization->variables.size());
+
+    for (const auto& [product, variable] : linearization->products) {
+      m_auxiliaries[to_index(variable) - m_variable_count] = { Auxiliary::Product, product.first, product.second, 0.0 };
+    }
+
+    for (const auto& [variable, expansion] : linearization->expansions) {
+      for (std::size_t k = 0; k < expansion.bits.size(); ++k) {
+        m_auxiliaries[to_index(expansion.bits[k]) - m_variable_count] = { Auxiliary::Bit, variable, k, expansion.lower };
+      }
+    }
+
+    m_compiled = std::make_unique<CompiledProblem>(std::move(*compiled));
+    m_problem = m_compiled.get();
+  }
+
+  bool BatchEvaluator::loaded() const
+  {
+    return m_problem != nullptr;
+  }
+
+  std::size_t BatchEvaluator::variable_count() const
+  {
+    return m_variable_count;
+  }
+
+  BatchEvaluation BatchEvaluator::evaluate(const std::vector<double>& values, std::size_t candidate_count) const
+  {
+    assert(loaded());
+    assert(values.size() == m_variable_count * candidate_count);
+
+    BatchEvaluation evaluation;
+    evaluation.candidate_count = candidate_count;
+    evaluation.activities.resize(m_problem->constraint_count() * candidate_count);
+    evaluation.objectives.resize(candidate_count);
+    evaluation.violations.resize(candidate_count);
+    evaluate(values.data(), candidate_count, evaluation.activities.data(), evaluation.objectives.data(), evaluation.violations.data());
+    return evaluation;
+  }
+
+  void BatchEvaluator::evaluate(const double* values, std::size_t candidate_count, double* activities, double* objectives, double* violations) const
+  {
+    assert(loaded());
+
+    if (m_auxiliaries.empty()) {
+      evaluate_columns(values, candidate_count, activities, objectives, violations);
+      return;
+    }
+
+    // the auxiliary variables are created after the variables they depend
+    // on, so their columns are computed in order
+
+    std::vector<double> columns(m_problem->variable_count() * candidate_count);
+    std::copy_n(values, m_variable_count * candidate_count, columns.begin());
+
+    for (std::size_t index = 0; index < m_auxiliaries.size(); ++index) {
+      const Auxiliary& auxiliary = m_auxiliaries[index];
+      const double* x = columns.data() + auxiliary.first * candidate_count;
+      double* out = columns.data() + (m_variable_count + index) * candidate_count;
+
+      switch (auxiliary.kind) {
+        case Auxiliary::Product:
+          {
+            const double* y = columns.data() + auxiliary.second * candidate_count;
+
+            for (std::size_t k = 0; k < candidate_count; ++k) {
+              out[k] = x[k] * y[k];
+            }
+          }
+          break;
+        case Auxiliary::Bit:
+          {
+            const double weight = std::ldexp(1.0, static_cast<int>(auxiliary.second));
+
+            for (std::size_t k = 0; k < candidate_count; ++k) {
+              const double offset = std::max(std::round(x[k] - auxiliary.lower), 0.0);
+              out[k] = std::fmod(std::floor(offset / weight), 2.0);
+            }
+          }
+          break;
+      }
+    }
+
+    evaluate_columns(columns.data(), candidate_count, activities, objectives, violations);
+  }
+
+  void BatchEvaluator::evaluate_columns(const double* values, std::size_t candidate_count, double* activities, double* objectives, double* violations) const
+  {
+    const CompiledProblem& problem = *m_problem;
+    const std::size_t variable_count = problem.variable_count();
+    const std::size_t constraint_count = problem.constraint_count();
+
+    const auto& row_starts = problem.row_starts();
+    const auto& column_indices = problem.column_indices();
+    const auto& coefficients = problem.values();
+    const auto& objective = problem.objective();
+
+    for (std::size_t first = 0; first < candidate_count; first += BlockSize) {
+      const std::size_t count = std::min(BlockSize, candidate_count - first);
+
+      auto column = [&](std::size_t variable) {
+        return values + variable * candidate_count + first;
+      };
+
+      // objective
+
+      double* objective_block = objectives + first;
+      std::fill_n(objective_block, count, problem.objective_constant());
+
+      for (std::size_t variable = 0; variable < variable_count; ++variable) {
+        if (objective[variable] != 0.0) {
+          add_scaled(objective_block, objective[variable], column(variable), count);
+        }
+      }
+
+      for (std::size_t k = 0; k < problem.quadratic_values().size(); ++k) {
+        add_scaled_product(objective_block, problem.quadratic_values()[k], column(problem.quadratic_rows()[k]), column(problem.quadratic_columns()[k]), count);
+      }
+
+      // constraints
+
+      for (std::size_t row = 0; row < constraint_count; ++row) {
+        double* activity = activities + row * candidate_count + first;
+        std::fill_n(activity, count, 0.0);
+
+        for (std::size_t k = row_starts[row]; k < row_starts[row + 1]; ++k) {
+          add_scaled(activity, coefficients[k], column(column_indices[k]), count);
+        }
+      }
+
+      if (violations == nullptr) {
+        continue;
+      }
+
+      double* violation = violations + first;
+      std::fill_n(violation, count, 0.0);
+
+      for (std::size_t row = 0; row < constraint_count; ++row) {
+        update_violation(violation, activities + row * candidate_count + first, problem.constraint_lower_bounds()[row], problem.constraint_upper_bounds()[row], count);
+      }
+
+      for (std::size_t variable = 0; variable < variable_count; ++variable) {
+        update_violation(violation, column(variable), problem.variable_lower_bounds()[variable], problem.variable_upper_bounds()[variable], count);
+      }
+    }
+  }
+
+}
@@ -0,0 +1,392 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include <lqp/BranchAndBoundSolver.h>
+// clang-format on
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include <lqp/SimplexSolver.h>
+
+#include "SimplexEngine.h"
+
+namespace lqp {
+
+  namespace {
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+    constexpr double IntegralityTolerance = 1e-6;
+    constexpr double RelativeGap = 1e-9;
+    constexpr auto IdlePeriod = std::chrono::microseconds(50);
+
+    struct BoundChange {
+      uint32_t variable;
+      double lower;
+      double upper;
+    };
+
+    struct Node {
+      double bound; // objective of the parent relaxation, minimized
+      std::vector<BoundChange> changes; // from the root, the last change of a variable wins
+      std::vector<BasisStatus> basis;
+    };
+
+    struct WorseBound {
+      bool operator()(const Node& lhs, const Node& rhs) const
+      {
+        return lhs.bound > rhs.bound;
+      }
+    };
+
+    class NodeQueue {
+    public:
+      void push(Node node)
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_nodes.push_back(std::move(node));
+        std::push_heap(m_nodes.begin(), m_nodes.end(), WorseBound());
+      }
+
+      std::optional<Node> pop_best()
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_nodes.empty()) {
+          return std::nullopt;
+        }
+
+        std::pop_heap(m_nodes.begin(), m_nodes.end(), WorseBound());
+        Node node = std::move(m_nodes.back());
+        m_nodes.pop_back();
+        return node;
+      }
+
+    private:
+      std::mutex m_mutex;
+      std::vector<Node> m_nodes;
+    };
+
+    class BranchAndBound {
+    public:
+      BranchAndBound(const CompiledProblem& problem, const SolverConfig& config, std::size_t thread_count);
+
+      Solution solve();
+
+    private:
+      void work(std::size_t index);
+      void dive(Node node, std::size_t index, details::SimplexEngine& engine, std::vector<BoundChange>& applied);
+      bool limit_reached() const;
+      bool is_pruned(double bound) const;
+      void improve_incumbent(double value, std::vector<double> values);
+
+      const CompiledProblem& m_problem;
+      std::vector<uint32_t> m_integer_variables;
+      double m_sign = 1.0;
+
+      std::size_t m_thread_count = 1;
+      std::vector<NodeQueue> m_queues;
+
+      details::SimplexOptions m_options;
+      bool m_verbose = false;
+
+      std::atomic<double> m_incumbent = Infinity;
+      std::mutex m_solution_mutex;
+      double m_solution_value = Infinity;
+      std::vector<double> m_solution;
+
+      std::atomic<std::size_t> m_pending = 0; // nodes in the queues or in a dive
+      std::atomic<std::size_t> m_node_count = 0;
+      std::atomic<bool> m_aborted = false;
+      std::atomic<bool> m_incomplete = false;
+      std::atomic<bool> m_unbounded = false;
+    };
+
+    BranchAndBound::BranchAndBound(const CompiledProblem& problem, const SolverConfig& config, std::size_t thread_count)
+    : m_problem(problem)
+    , m_sign(problem.sense() == Sense::Maximize ? -1.0 : 1.0)
+    , m_thread_count(thread_count)
+    , m_queues(thread_count)
+    {
+      const auto& categories = problem.variable_categories();
+
+      for (std::size_t variable = 0; variable < categories.size(); ++variable) {
+        if (categories[variable] != VariableCategory::Continuous) {
+          m_integer_variables.push_back(static_cast<uint32_t>(variable));
+        }
+      }
+
+      m_options.stop = config.stop;
+      m_verbose = config.verbose;
+
+      if (config.timeout != std::chrono::milliseconds::max()) {
+        m_options.deadline = std::chrono::steady_clock::now() + config.timeout;
+      }
+    }
+
+    Solution BranchAndBound::solve()
+    {
+      m_pending = 1;
+      m_queues.front().push({ -Infinity, {}, {} });
+
+      std::vector<std::thread> workers;
+      workers.reserve(m_thread_count - 1);
+
+      for (std::size_t index = 1; index < m_thread_count; ++index) {
+        workers.emplace_back(&BranchAndBound::work, this, index);
+      }
+
+      work(0);
+
+      for (std::thread& worker : workers) {
+        worker.join();
+      }
+
+      if (m_verbose) {
+        std::printf("%8zu nodes\n", m_node_count.load());
+      }
+
+      const bool has_solution = m_solution_value != Infinity;
+
+      // an integer solution and an unbounded relaxation of a node prove
+      // that the problem is unbounded: the ray of the node keeps the
+      // solution integer once scaled
+      if (m_unbounded && has_solution) {
+        return { SolutionStatus::UnboundedSolution };
+      }
+
+      if (m_aborted || m_incomplete) {
+        if (has_solution) {
+          return { SolutionStatus::Feasible, std::move(m_solution) };
+        }
+
+        return { SolutionStatus::Undefined };
+      }
+
+      if (has_solution) {
+        return { SolutionStatus::Optimal, std::move(m_solution) };
+      }
+
+      if (m_unbounded) {
+        return { SolutionStatus::UnboundedSolution };
+      }
+
+      return { SolutionStatus::NoFeasibleSolution };
+    }
+
+    void BranchAndBound::work(std::size_t index)
+    {
+      details::SimplexEngine engine(m_problem);
+      std::vector<BoundChange> applied;
+
+      while (!m_aborted.load(std::memory_order_relaxed)) {
+        std::optional<Node> node = m_queues[index].pop_best();
+
+        for (std::size_t offset = 1; !node && offset < m_thread_count; ++offset) {
+          node = m_queues[(index + offset) % m_thread_count].pop_best();
+        }
+
+        if (!node) {
+          if (m_pending.load() == 0) {
+            return;
+          }
+
+          std::this_thread::sleep_for(IdlePeriod);
+          continue;
+        }
+
+        if (is_pruned(node->bound)) {
+          --m_pending;
+          continue;
+        }
+
+        dive(std::move(*node), index, engine, applied);
+      }
+    }
+
+    // processes the node and one of its children until the dive is pruned,
+    // the other children go to the queue
+    void BranchAndBound::dive(Node node, std::size_t index, details::SimplexEngine& engine, std::vector<BoundChange>& applied)
+    {
+      for (const BoundChange& change : applied) {
+        engine.set_variable_bounds(change.variable, m_problem.variable_lower_bounds()[change.variable], m_problem.variable_upper_bounds()[change.variable]);
+      }
+
+      applied = std::move(node.changes);
+
+      for (const BoundChange& change : applied) {
+        engine.set_variable_bounds(change.variable, change.lower, change.upper);
+      }
+
+      if (!node.basis.empty()) {
+        engine.set_basis(node.basis);
+      }
+
+      for (;;) {
+        const SolutionStatus status = engine.solve(m_options);
+        ++m_node_count;
+
+        if (status == SolutionStatus::NoFeasibleSolution) {
+          break;
+        }
+
+        if (status == SolutionStatus::UnboundedSolution) {
+          m_unbounded = true;
+          break;
+        }
+
+        if (status != SolutionStatus::Optimal) {
+          if (limit_reached()) {
+            m_aborted = true;
+          } else {
+            m_incomplete = true;
+          }
+
+          break;
+        }
+
+        const double value = m_sign * engine.objective_value();
+
+        if (is_pruned(value)) {
+          break;
+        }
+
+        // most fractional variable
+
+        std::vector<double> values = engine.primal_values();
+        std::size_t branching = m_problem.variable_count();
+        double best_fractionality = IntegralityTolerance;
+
+        for (const uint32_t variable : m_integer_variables) {
+          const double fractionality = std::abs(values[variable] - std::round(values[variable]));
+
+          if (fractionality > best_fractionality) {
+            best_fractionality = fractionality;
+            branching = variable;
+          }
+        }
+
+        if (branching == m_problem.variable_count()) {
+          for (const uint32_t variable : m_integer_variables) {
+            values[variable] = std::round(values[variable]);
+          }
+
+          improve_incumbent(value, std::move(values));
+          break;
+        }
+
+        const double lower = engine.variable_lower_bound(branching);
+        const double upper = engine.variable_upper_bound(branching);
+        const double down = std::floor(values[branching]);
+        const BoundChange down_change = { static_cast<uint32_t>(branching), lower, down };
+        const BoundChange up_change = { static_cast<uint32_t>(branching), down + 1.0, upper };
+        const bool dive_down = values[branching] - down < 0.5;
+
+        Node other = { value, applied, engine.basis() };
+        other.changes.push_back(dive_down ? up_change : down_change);
+        m_pending += 1; // two children replace this node
+        m_queues[index].push(std::move(other));
+
+        const BoundChange& change = dive_down ? down_change : up_change;
+        applied.push_back(change);
+        engine.set_variable_bounds(change.variable, change.lower, change.upper);
+      }
+
+      --m_pending;
+    }
+
+    bool BranchAndBound::limit_reached() const
+    {
+      if (m_options.stop != nullptr && m_options.stop->load(std::memory_order_relaxed)) {
+        return true;
+      }
+
+      return m_options.deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= m_options.deadline;
+    }
+
+    bool BranchAndBound::is_pruned(double bound) const
+    {
+      const double incumbent = m_incumbent.load(std::memory_order_relaxed);
+      return bound >= incumbent - RelativeGap * std::max(1.0, std::abs(incumbent));
+    }
+
+    void BranchAndBound::improve_incumbent(double value, std::vector<double> values)
+    {
+      double current = m_incumbent.load();
+
+      do {
+        if (value >= current) {
+          return;
+        }
+      } while (!m_incumbent.compare_exchange_weak(current, value));
+
+      // the values follow the objective, a better incumbent may have been
+      // stored in the meantime
+      std::lock_guard<std::mutex> lock(m_solution_mutex);
+
+      if (value < m_solution_value) {
+        m_solution_value = value;
+        m_solution = std::move(values);
+
+        if (m_verbose) {
+          std::printf("%8zu: incumbent = %17.9e\n", m_node_count.load(), m_sign * value);
+        }
+      }
+    }
+
+  }
+
+  BranchAndBoundSolver::BranchAndBoundSolver(std::size_t thread_count)
+  : m_thread_count(thread_count)
+  {
+  }
+
+  bool BranchAndBoundSolver::available() const
+  {
+    return true;
+  }
+
+  Solution BranchAndBoundSolver::solve(const Problem& problem, const SolverConfig& config)
+  {
+    const auto compiled = problem.compile();
+
+    if (!compiled) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    return solve(*compiled, config);
+  }
+
+  Solution BranchAndBoundSolver::solve(const CompiledProblem& problem, const SolverConfig& config)
+  {
+    if (!config.use_mip) {
+      SimplexSolver relaxation;
+      return relaxation.solve(problem, config);
+    }
+
+    if (problem.has_quadratic_objective()) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    std::size_t thread_count = m_thread_count;
+
+    if (thread_count == 0) {
+      thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    BranchAndBound branch_and_bound(problem, config, thread_count);
+    return branch_and_bound.solve();
+  }
+
+}
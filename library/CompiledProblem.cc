@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include <lqp/CompiledProblem.h>
+// clang-format on
+
+#include <cassert>
+
+namespace lqp {
+
+  std::size_t CompiledProblem::variable_count() const
+  {
+    return m_objective.size();
+  }
+
+  std::size_t CompiledProblem::constraint_count() const
+  {
+    return m_row_starts.size() - 1;
+  }
+
+  std::size_t CompiledProblem::nonzero_count() const
+  {
+    return m_values.size();
+  }
+
+  Sense CompiledProblem::sense() const
+  {
+    return m_sense;
+  }
+
+  double CompiledProblem::objective_constant() const
+  {
+    return m_objective_constant;
+  }
+
+  const std::vector<double>& CompiledProblem::objective() const
+  {
+    return m_objective;
+  }
+
+  bool CompiledProblem::has_quadratic_objective() const
+  {
+    return !m_quadratic_values.empty();
+  }
+
+  const std::vector<uint32_t>& CompiledProblem::quadratic_rows() const
+  {
+    return m_quadratic_rows;
+  }
+
+  const std::vector<uint32_t>& CompiledProblem::quadratic_columns() const
+  {
+    return m_quadratic_columns;
+  }
+
+  const std::vector<double>& CompiledProblem::quadratic_values() const
+  {
+    return m_quadratic_values;
+  }
+
+  const std::vector<VariableCategory>& CompiledProblem::variable_categories() const
+  {
+    return m_variable_categories;
+  }
+
+  const std::vector<double>& CompiledProblem::variable_lower_bounds() const
+  {
+    return m_variable_lower_bounds;
+  }
+
+  const std::vector<double>& CompiledProblem::variable_upper_bounds() const
+  {
+    return m_variable_upper_bounds;
+  }
+
+  const std::vector<double>& CompiledProblem::constraint_lower_bounds() const
+  {
+    return m_constraint_lower_bounds;
+  }
+
+  const std::vector<double>& CompiledProblem::constraint_upper_bounds() const
+  {
+    return m_constraint_upper_bounds;
+  }
+
+  const std::vector<std::size_t>& CompiledProblem::row_starts() const
+  {
+    return m_row_starts;
+  }
+
+  const std::vector<uint32_t>& CompiledProblem::column_indices() const
+  {
+    return m_column_indices;
+  }
+
+  const std::vector<double>& CompiledProblem::values() const
+  {
+    return m_values;
+  }
+
+  std::string_view CompiledProblem::objective_name() const
+  {
+    return m_objective_name;
+  }
+
+  std::string_view CompiledProblem::variable_name(std::size_t index) const
+  {
+    return m_variable_names.get(index);
+  }
+
+  std::string_view CompiledProblem::constraint_name(std::size_t index) const
+  {
+    return m_constraint_names.get(index);
+  }
+
+  void CompiledProblem::NameTable::add(const std::string& name)
+  {
+    buffer.append(name);
+    offsets.push_back(buffer.size());
+  }
+
+  std::string_view CompiledProblem::NameTable::get(std::size_t index) const
+  {
+    assert(index + 1 < offsets.size());
+    return std::string_view(buffer).substr(offsets[index], offsets[index + 1] - offsets[index]);
+  }
+
+}
@@ -7,12 +7,152 @@
 
 #include <cassert>
 
-#include <map>
-#include <tuple>
+#include <algorithm>
 
 #include <lqp/Solution.h>
 
 namespace lqp {
+  namespace {
+
+    bool is_ordered_before(const ExprLinearTerm& lhs, const ExprLinearTerm& rhs)
+    {
+      return lhs.variable < rhs.variable;
+    }
+
+    bool is_ordered_before(const ExprQuadraticTerm& lhs, const ExprQuadraticTerm& rhs)
+    {
+      if (lhs.variables[0] == rhs.variables[0]) {
+        return lhs.variables[1] < rhs.variables[1];
+      }
+
+      return lhs.variables[0] < rhs.variables[0];
+    }
+
+    bool has_same_variables(const ExprLinearTerm& lhs, const ExprLinearTerm& rhs)
+    {
+      return lhs.variable == rhs.variable;
+    }
+
+    bool has_same_variables(const ExprQuadraticTerm& lhs, const ExprQuadraticTerm& rhs)
+    {
+      return lhs.variables[0] == rhs.variables[0] && lhs.variables[1] == rhs.variables[1];
+    }
+
+    // sort the terms in place, merge the terms with the same variables and
+    // remove the null terms, without any allocation
+    template<typename Term>
+    void normalize_terms(std::vector<Term>& terms)
+    {
+      auto compare = [](const Term& lhs, const Term& rhs) {
+        return is_ordered_before(lhs, rhs);
+      };
+
+      if (!std::is_sorted(terms.begin(), terms.end(), compare)) {
+        std::sort(terms.begin(), terms.end(), compare);
+      }
+
+      auto output = terms.begin();
+
+      for (auto it = terms.begin(); it != terms.end();) {
+        Term term = *it;
+
+        for (++it; it != terms.end() && has_same_variables(*it, term); ++it) {
+          term.coefficient += it->coefficient;
+        }
+
+        if (term.coefficient != 0.0) {
+          *output++ = term;
+        }
+      }
+
+      terms.erase(output, terms.end());
+    }
+
+    double value_of(const std::vector<double>& values, VariableId variable)
+    {
+      const std::size_t index = to_index(variable);
+      return index < values.size() ? values[index] : 0.0;
+    }
+
+    // binary search when the terms are normalized, otherwise sum all the
+    // pending terms with the same variables
+    template<typename Term>
+    double find_coefficient(const std::vector<Term>& terms, const Term& key, bool normalized)
+    {
+      if (normalized) {
+        auto it = std::lower_bound(terms.begin(), terms.end(), key, [](const Term& lhs, const Term& rhs) {
+          return is_ordered_before(lhs, rhs);
+        });
+
+        if (it != terms.end() && has_same_variables(*it, key)) {
+          return it->coefficient;
+        }
+
+        return 0.0;
+      }
+
+      double coefficient = 0.0;
+
+      for (const auto& term : terms) {
+        if (has_same_variables(term, key)) {
+          coefficient += term.coefficient;
+        }
+      }
+
+      return coefficient;
+    }
+
+    void scatter_terms(const std::vector<ExprLinearTerm>& terms, std::vector<double>& coefficients)
+    {
+      for (const auto& term : terms) {
+        assert(to_index(term.variable) < coefficients.size());
+        coefficients[to_index(term.variable)] += term.coefficient;
+      }
+    }
+
+    // add factor * other to terms, both being normalized, with a backward
+    // merge in the buffer of terms so that the result stays normalized
+    template<typename Term>
+    void merge_terms(std::vector<Term>& terms, const std::vector<Term>& other, double factor)
+    {
+      if (other.empty()) {
+        return;
+      }
+
+      std::size_t lhs = terms.size();
+      std::size_t rhs = other.size();
+      std::size_t output = lhs + rhs;
+
+      terms.resize(output);
+
+      while (rhs > 0) {
+        if (lhs > 0 && is_ordered_before(other[rhs - 1], terms[lhs - 1])) {
+          terms[--output] = terms[--lhs];
+        } else if (lhs > 0 && has_same_variables(terms[lhs - 1], other[rhs - 1])) {
+          Term term = terms[--lhs];
+          term.coefficient += factor * other[--rhs].coefficient;
+          terms[--output] = term;
+        } else {
+          Term term = other[--rhs];
+          term.coefficient *= factor;
+          terms[--output] = term;
+        }
+      }
+
+      // terms[0, lhs) are in place, terms[output, end) must be moved next
+      // to them, without the null terms
+      auto destination = terms.begin() + static_cast<std::ptrdiff_t>(lhs);
+
+      for (auto it = terms.begin() + static_cast<std::ptrdiff_t>(output); it != terms.end(); ++it) {
+        if (it->coefficient != 0.0) {
+          *destination++ = *it;
+        }
+      }
+
+      terms.erase(destination, terms.end());
+    }
+
+  }
 
   LExpr::LExpr()
   : m_constant(0.0)
@@ -48,18 +188,17 @@ namespace lqp {
 
   double LExpr::linear_coefficient(VariableId variable) const
   {
-    for (const auto& term : m_linear_terms) {
-      if (term.variable == variable) {
-        return term.coefficient;
-      }
-    }
+    return find_coefficient(m_linear_terms, ExprLinearTerm{ 0.0, variable }, m_normalized);
+  }
 
-    return 0.0;
+  void LExpr::scatter_linear_coefficients(std::vector<double>& coefficients) const
+  {
+    scatter_terms(m_linear_terms, coefficients);
   }
 
-  std::vector<ExprLinearTerm> LExpr::linear_terms() const
+  TermSpan<ExprLinearTerm> LExpr::linear_terms() const
   {
-    return m_linear_terms;
+    return { m_linear_terms.data(), m_linear_terms.size() };
   }
 
   LExpr& LExpr::operator+=(const LExpr& other)
@@ -69,13 +208,7 @@ namespace lqp {
       return *this;
     }
 
-    m_constant += other.m_constant;
-
-    if (!other.m_linear_terms.empty()) {
-      m_linear_terms.insert(m_linear_terms.end(), other.m_linear_terms.begin(), other.m_linear_terms.end());
-    }
-
-    normalize();
+    merge(other, 1.0);
     return *this;
   }
 
@@ -84,12 +217,12 @@ namespace lqp {
     if (&other == this) {
       m_constant = 0.0;
       m_linear_terms.clear();
+      m_normalized = true;
       return *this;
     }
 
-    LExpr expr(other);
-    expr *= -1.0;
-    return operator+=(expr);
+    merge(other, -1.0);
+    return *this;
   }
 
   LExpr& LExpr::operator*=(double factor)
@@ -97,6 +230,7 @@ namespace lqp {
     if (factor == 0.0) {
       m_constant = 0.0;
       m_linear_terms.clear();
+      m_normalized = true;
       return *this;
     }
 
@@ -120,12 +254,31 @@ namespace lqp {
     return *this;
   }
 
+  void LExpr::reserve(std::size_t count)
+  {
+    m_linear_terms.reserve(count);
+  }
+
+  void LExpr::add_term(double coefficient, VariableId variable)
+  {
+    m_linear_terms.push_back({ coefficient, variable });
+    m_normalized = false;
+  }
+
+  void LExpr::finalize()
+  {
+    if (!m_normalized) {
+      normalize();
+    }
+  }
+
   double LExpr::evaluate(const Solution& solution) const
   {
+    const auto& values = solution.values();
     double value = m_constant;
 
     for (const auto& term : m_linear_terms) {
-      value += term.coefficient * solution.value(term.variable);
+      value += term.coefficient * value_of(values, term.variable);
     }
 
     return value;
@@ -133,19 +286,22 @@ namespace lqp {
 
   void LExpr::normalize()
   {
-    std::map<VariableId, double> linear_terms;
+    normalize_terms(m_linear_terms);
+    m_normalized = true;
+  }
 
-    for (auto& term : m_linear_terms) {
-      linear_terms[term.variable] += term.coefficient;
+  void LExpr::merge(const LExpr& other, double factor)
+  {
+    if (!other.m_normalized) {
+      LExpr expr(other);
+      expr.normalize();
+      merge(expr, factor);
+      return;
     }
 
-    m_linear_terms.clear();
-
-    for (auto [variable, coefficient] : linear_terms) {
-      if (coefficient != 0.0) {
-        m_linear_terms.push_back({ coefficient, variable });
-      }
-    }
+    finalize();
+    m_constant += factor * other.m_constant;
+    merge_terms(m_linear_terms, other.m_linear_terms, factor);
   }
 
   QExpr::QExpr()
@@ -167,6 +323,7 @@ namespace lqp {
   QExpr::QExpr(const LExpr& expr)
   : m_constant(expr.m_constant)
   , m_linear_terms(expr.m_linear_terms)
+  , m_normalized(expr.m_normalized)
   {
   }
 
@@ -203,7 +360,7 @@ namespace lqp {
           term1.coefficient * term2.coefficient, { term1.variable, term2.variable }
         };
 
-        if (result.variables[0] < result.variables[1]) {
+        if (result.variables[0] > result.variables[1]) {
           std::swap(result.variables[0], result.variables[1]);
         }
 
@@ -231,13 +388,7 @@ namespace lqp {
 
   double QExpr::linear_coefficient(VariableId variable) const
   {
-    for (const auto& term : m_linear_terms) {
-      if (term.variable == variable) {
-        return term.coefficient;
-      }
-    }
-
-    return 0.0;
+    return find_coefficient(m_linear_terms, ExprLinearTerm{ 0.0, variable }, m_normalized);
   }
 
   double QExpr::quadratic_coefficient(VariableId variable1, VariableId variable2) const
@@ -246,23 +397,26 @@ namespace lqp {
       std::swap(variable1, variable2);
     }
 
-    for (const auto& term : m_quadratic_terms) {
-      if (term.variables[0] == variable1 && term.variables[1] == variable2) {
-        return term.coefficient;
-      }
-    }
+    const ExprQuadraticTerm key = {
+      0.0, { variable1, variable2 }
+    };
+
+    return find_coefficient(m_quadratic_terms, key, m_normalized);
+  }
 
-    return 0.0;
+  void QExpr::scatter_linear_coefficients(std::vector<double>& coefficients) const
+  {
+    scatter_terms(m_linear_terms, coefficients);
   }
 
-  std::vector<ExprLinearTerm> QExpr::linear_terms() const
+  TermSpan<ExprLinearTerm> QExpr::linear_terms() const
   {
-    return m_linear_terms;
+    return { m_linear_terms.data(), m_linear_terms.size() };
   }
 
-  std::vector<ExprQuadraticTerm> QExpr::quadratic_terms() const
+  TermSpan<ExprQuadraticTerm> QExpr::quadratic_terms() const
   {
-    return m_quadratic_terms;
+    return { m_quadratic_terms.data(), m_quadratic_terms.size() };
   }
 
   QExpr& QExpr::operator+=(const QExpr& other)
@@ -272,17 +426,7 @@ namespace lqp {
       return *this;
     }
 
-    m_constant += other.m_constant;
-
-    if (!other.m_linear_terms.empty()) {
-      m_linear_terms.insert(m_linear_terms.end(), other.m_linear_terms.begin(), other.m_linear_terms.end());
-    }
-
-    if (!other.m_quadratic_terms.empty()) {
-      m_quadratic_terms.insert(m_quadratic_terms.end(), other.m_quadratic_terms.begin(), other.m_quadratic_terms.end());
-    }
-
-    normalize();
+    merge(other, 1.0);
     return *this;
   }
 
@@ -292,12 +436,12 @@ namespace lqp {
       m_constant = 0.0;
       m_linear_terms.clear();
       m_quadratic_terms.clear();
+      m_normalized = true;
       return *this;
     }
 
-    QExpr expr(other);
-    expr *= -1.0;
-    return operator+=(expr);
+    merge(other, -1.0);
+    return *this;
   }
 
   QExpr& QExpr::operator*=(double factor)
@@ -306,6 +450,7 @@ namespace lqp {
       m_constant = 0.0;
       m_linear_terms.clear();
       m_quadratic_terms.clear();
+      m_normalized = true;
       return *this;
     }
 
@@ -337,16 +482,48 @@ namespace lqp {
     return *this;
   }
 
+  void QExpr::reserve(std::size_t linear_count, std::size_t quadratic_count)
+  {
+    m_linear_terms.reserve(linear_count);
+    m_quadratic_terms.reserve(quadratic_count);
+  }
+
+  void QExpr::add_term(double coefficient, VariableId variable)
+  {
+    m_linear_terms.push_back({ coefficient, variable });
+    m_normalized = false;
+  }
+
+  void QExpr::add_term(double coefficient, VariableId variable1, VariableId variable2)
+  {
+    if (variable1 > variable2) {
+      std::swap(variable1, variable2);
+    }
+
+    m_quadratic_terms.push_back({
+        coefficient, { variable1, variable2 }
+    });
+    m_normalized = false;
+  }
+
+  void QExpr::finalize()
+  {
+    if (!m_normalized) {
+      normalize();
+    }
+  }
+
   double QExpr::evaluate(const Solution& solution) const
   {
+    const auto& values = solution.values();
     double value = m_constant;
 
     for (const auto& term : m_linear_terms) {
-      value += term.coefficient * solution.value(term.variable);
+      value += term.coefficient * value_of(values, term.variable);
     }
 
     for (const auto& term : m_quadratic_terms) {
-      value += term.coefficient * solution.value(term.variables[0]) * solution.value(term.variables[1]);
+      value += term.coefficient * value_of(values, term.variables[0]) * value_of(values, term.variables[1]);
     }
 
     return value;
@@ -354,36 +531,29 @@ namespace lqp {
 
   void QExpr::normalize()
   {
-    std::map<VariableId, double> linear_terms;
-
-    for (auto& term : m_linear_terms) {
-      linear_terms[term.variable] += term.coefficient;
-    }
+    normalize_terms(m_linear_terms);
 
-    m_linear_terms.clear();
-
-    for (auto [variable, coefficient] : linear_terms) {
-      if (coefficient != 0.0) {
-        m_linear_terms.push_back({ coefficient, variable });
-      }
-    }
+    assert(std::all_of(m_quadratic_terms.begin(), m_quadratic_terms.end(), [](const ExprQuadraticTerm& term) {
+      return to_index(term.variables[0]) <= to_index(term.variables[1]);
+    }));
 
-    std::map<std::tuple<VariableId, VariableId>, double> quadratic_terms;
+    normalize_terms(m_quadratic_terms);
+    m_normalized = true;
+  }
 
-    for (auto& term : m_quadratic_terms) {
-      assert(to_index(term.variables[0]) <= to_index(term.variables[1]));
-      quadratic_terms[std::make_tuple(term.variables[0], term.variables[1])] += term.coefficient;
+  void QExpr::merge(const QExpr& other, double factor)
+  {
+    if (!other.m_normalized) {
+      QExpr expr(other);
+      expr.normalize();
+      merge(expr, factor);
+      return;
     }
 
-    m_quadratic_terms.clear();
-
-    for (auto [variables, coefficient] : quadratic_terms) {
-      if (coefficient != 0.0) {
-        m_quadratic_terms.push_back({
-            coefficient, { std::get<0>(variables), std::get<1>(variables) }
-        });
-      }
-    }
+    finalize();
+    m_constant += factor * other.m_constant;
+    merge_terms(m_linear_terms, other.m_linear_terms, factor);
+    merge_terms(m_quadratic_terms, other.m_quadratic_terms, factor);
   }
 
 }
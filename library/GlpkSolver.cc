@@ -6,10 +6,16 @@
 // clang-format on
 
 #include <cassert>
+#include <cmath>
 #include <cstdio>
 
+#include <algorithm>
+#include <atomic>
 #include <limits>
 #include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
 
 #include <glpk.h>
 
@@ -19,11 +25,34 @@ namespace lqp {
     constexpr double Ignored = 0.0;
 
     struct Matrix {
+      explicit Matrix(std::size_t nonzero_count)
+      {
+        row_indices.reserve(nonzero_count + 1);
+        col_indices.reserve(nonzero_count + 1);
+        coefficients.reserve(nonzero_count + 1);
+
+        // first element is not used by glpk
+        row_indices.push_back(0);
+        col_indices.push_back(0);
+        coefficients.push_back(0.0);
+      }
+
+      int size() const
+      {
+        return static_cast<int>(coefficients.size() - 1);
+      }
+
       std::vector<int> row_indices;
       std::vector<int> col_indices;
       std::vector<double> coefficients;
     };
 
+    // the names are only useful in the output files
+    bool needs_names(const SolverConfig& config)
+    {
+      return !config.problem_output.empty() || !config.solution_output.empty();
+    }
+
     SolutionStatus to_solver_status(int val)
     {
       switch (val) {
@@ -46,18 +75,66 @@ namespace lqp {
       return SolutionStatus::Error;
     }
 
-    template<typename T, typename U>
-    void define_variables(glp_prob* prob, const std::vector<T>& variables, const U& objective)
+    void define_objective(glp_prob* prob, Sense sense)
+    {
+      switch (sense) {
+        case Sense::Maximize:
+          glp_set_obj_dir(prob, GLP_MAX);
+          break;
+        case Sense::Minimize:
+          glp_set_obj_dir(prob, GLP_MIN);
+          break;
+      }
+    }
+
+    int to_bounds_type(double lower, double upper)
     {
-      glp_add_cols(prob, static_cast<int>(variables.size()));
+      const bool has_lower = std::isfinite(lower);
+      const bool has_upper = std::isfinite(upper);
 
-      std::size_t col_index = 0;
-      int col = 1;
+      if (has_lower && has_upper) {
+        return lower == upper ? GLP_FX : GLP_DB;
+      }
 
-      for (auto& variable : variables) {
-        glp_set_col_name(prob, col, variable.name.c_str());
+      if (has_lower) {
+        return GLP_LO;
+      }
+
+      if (has_upper) {
+        return GLP_UP;
+      }
+
+      return GLP_FR;
+    }
+
+    std::string name_of(std::string_view name)
+    {
+      return std::string(name);
+    }
+
+    void load_compiled_problem(glp_prob* prob, const CompiledProblem& problem, bool with_names)
+    {
+      define_objective(prob, problem.sense());
+
+      if (with_names) {
+        glp_set_obj_name(prob, name_of(problem.objective_name()).c_str());
+      }
 
-        switch (variable.category) {
+      /*
+       * cols (variables)
+       */
+
+      const std::size_t variable_count = problem.variable_count();
+      glp_add_cols(prob, static_cast<int>(variable_count));
+
+      for (std::size_t index = 0; index < variable_count; ++index) {
+        const int col = static_cast<int>(index + 1);
+
+        if (with_names) {
+          glp_set_col_name(prob, col, name_of(problem.variable_name(index)).c_str());
+        }
+
+        switch (problem.variable_categories()[index]) {
           case VariableCategory::Continuous:
             glp_set_col_kind(prob, col, GLP_CV);
             break;
@@ -66,95 +143,353 @@ namespace lqp {
             break;
           case VariableCategory::Binary:
             glp_set_col_kind(prob, col, GLP_BV);
-            assert(variable.range.type == VariableRange::Bounded);
             break;
         }
 
-        switch (variable.range.type) {
-          case VariableRange::Unbounded:
-            glp_set_col_bnds(prob, col, GLP_FR, Ignored, Ignored);
-            break;
-          case VariableRange::LowerBounded:
-            glp_set_col_bnds(prob, col, GLP_LO, variable.range.lower, Ignored);
-            break;
-          case VariableRange::UpperBounded:
-            glp_set_col_bnds(prob, col, GLP_UP, Ignored, variable.range.upper);
-            break;
-          case VariableRange::Bounded:
-            if (variable.category != VariableCategory::Binary) {
-              glp_set_col_bnds(prob, col, GLP_DB, variable.range.lower, variable.range.upper);
-            }
-            break;
-          case VariableRange::Fixed:
-            glp_set_col_bnds(prob, col, GLP_FX, variable.range.lower, variable.range.upper);
-            break;
+        if (problem.variable_categories()[index] != VariableCategory::Binary) {
+          const double lower = problem.variable_lower_bounds()[index];
+          const double upper = problem.variable_upper_bounds()[index];
+          glp_set_col_bnds(prob, col, to_bounds_type(lower, upper), std::isfinite(lower) ? lower : Ignored, std::isfinite(upper) ? upper : Ignored);
         }
 
-        const double coefficient = objective.expression.linear_coefficient(VariableId{ col_index });
-
-        if (coefficient != 0.0) {
+        if (const double coefficient = problem.objective()[index]; coefficient != 0.0) {
           glp_set_obj_coef(prob, col, coefficient);
         }
+      }
 
-        ++col_index;
-        ++col;
+      /*
+       * rows (constraints)
+       */
+
+      const std::size_t constraint_count = problem.constraint_count();
+      glp_add_rows(prob, static_cast<int>(constraint_count));
+
+      for (std::size_t index = 0; index < constraint_count; ++index) {
+        const int row = static_cast<int>(index + 1);
+
+        if (with_names) {
+          glp_set_row_name(prob, row, name_of(problem.constraint_name(index)).c_str());
+        }
+
+        const double lower = problem.constraint_lower_bounds()[index];
+        const double upper = problem.constraint_upper_bounds()[index];
+        glp_set_row_bnds(prob, row, to_bounds_type(lower, upper), std::isfinite(lower) ? lower : Ignored, std::isfinite(upper) ? upper : Ignored);
+      }
+
+      /*
+       * matrix
+       */
+
+      const std::size_t nonzero_count = problem.nonzero_count();
+
+      // first element is not used by glpk
+      std::vector<int> row_indices(nonzero_count + 1, 0);
+      std::vector<int> col_indices(nonzero_count + 1, 0);
+      std::vector<double> coefficients(nonzero_count + 1, 0.0);
+
+      const auto& row_starts = problem.row_starts();
+
+      for (std::size_t index = 0; index < constraint_count; ++index) {
+        std::fill(row_indices.begin() + static_cast<std::ptrdiff_t>(row_starts[index] + 1), row_indices.begin() + static_cast<std::ptrdiff_t>(row_starts[index + 1] + 1), static_cast<int>(index + 1));
+      }
+
+      std::transform(problem.column_indices().begin(), problem.column_indices().end(), col_indices.begin() + 1, [](uint32_t col_index) {
+        return static_cast<int>(col_index + 1);
+      });
+
+      std::copy(problem.values().begin(), problem.values().end(), coefficients.begin() + 1);
+
+      glp_load_matrix(prob, static_cast<int>(nonzero_count), row_indices.data(), col_indices.data(), coefficients.data());
+    }
+
+    void set_col_range(glp_prob* prob, int col, const VariableRange& range)
+    {
+      switch (range.type) {
+        case VariableRange::Unbounded:
+          glp_set_col_bnds(prob, col, GLP_FR, Ignored, Ignored);
+          break;
+        case VariableRange::LowerBounded:
+          glp_set_col_bnds(prob, col, GLP_LO, range.lower, Ignored);
+          break;
+        case VariableRange::UpperBounded:
+          glp_set_col_bnds(prob, col, GLP_UP, Ignored, range.upper);
+          break;
+        case VariableRange::Bounded:
+          glp_set_col_bnds(prob, col, GLP_DB, range.lower, range.upper);
+          break;
+        case VariableRange::Fixed:
+          glp_set_col_bnds(prob, col, GLP_FX, range.lower, range.upper);
+          break;
+      }
+    }
+
+    // the constant of the expression is moved to the bounds
+    void set_row_range(glp_prob* prob, int row, const VariableRange& range, double constant)
+    {
+      switch (range.type) {
+        case VariableRange::Unbounded:
+          glp_set_row_bnds(prob, row, GLP_FR, Ignored, Ignored);
+          break;
+        case VariableRange::LowerBounded:
+          glp_set_row_bnds(prob, row, GLP_LO, range.lower - constant, Ignored);
+          break;
+        case VariableRange::UpperBounded:
+          glp_set_row_bnds(prob, row, GLP_UP, Ignored, range.upper - constant);
+          break;
+        case VariableRange::Bounded:
+          glp_set_row_bnds(prob, row, GLP_DB, range.lower - constant, range.upper - constant);
+          break;
+        case VariableRange::Fixed:
+          glp_set_row_bnds(prob, row, GLP_FX, range.lower - constant, range.upper - constant);
+          break;
       }
     }
 
+    VariableRange to_range(Operator op)
+    {
+      switch (op) {
+        case Operator::GreaterEqual:
+          return lower_bound(0.0);
+        case Operator::Equal:
+          return fixed(0.0);
+        case Operator::LessEqual:
+          return upper_bound(0.0);
+      }
+
+      assert(false);
+      return {};
+    }
+
     template<typename T>
-    void define_constraints(glp_prob* prob, const std::vector<T>& constraints, Matrix& matrix)
+    void define_variable(glp_prob* prob, int col, const T& variable, double coefficient, bool with_names)
     {
-      glp_add_rows(prob, static_cast<int>(constraints.size()));
+      if (with_names && !variable.name.empty()) {
+        glp_set_col_name(prob, col, variable.name.c_str());
+      }
 
-      int row = 1;
+      switch (variable.category) {
+        case VariableCategory::Continuous:
+          glp_set_col_kind(prob, col, GLP_CV);
+          break;
+        case VariableCategory::Integer:
+          glp_set_col_kind(prob, col, GLP_IV);
+          break;
+        case VariableCategory::Binary:
+          glp_set_col_kind(prob, col, GLP_BV);
+          assert(variable.range.type == VariableRange::Bounded);
+          break;
+      }
+
+      if (variable.category != VariableCategory::Binary) {
+        set_col_range(prob, col, variable.range);
+      }
+
+      if (coefficient != 0.0) {
+        glp_set_obj_coef(prob, col, coefficient);
+      }
+    }
+
+    // the auxiliary variables come from the linearization of the problem
+    template<typename T, typename U>
+    std::size_t define_variables(glp_prob* prob, const std::vector<T>& variables, const std::vector<T>& auxiliary_variables, const U& objective, bool with_names)
+    {
+      const std::size_t variable_count = variables.size() + auxiliary_variables.size();
+      glp_add_cols(prob, static_cast<int>(variable_count));
+
+      std::vector<double> objective_coefficients(variable_count, 0.0);
+      objective.expression.scatter_linear_coefficients(objective_coefficients);
+
+      int col = 1;
+
+      for (auto& variable : variables) {
+        define_variable(prob, col, variable, objective_coefficients[static_cast<std::size_t>(col - 1)], with_names);
+        ++col;
+      }
+
+      for (auto& variable : auxiliary_variables) {
+        define_variable(prob, col, variable, objective_coefficients[static_cast<std::size_t>(col - 1)], with_names);
+        ++col;
+      }
 
-      for (auto& constraint : constraints) {
+      return variable_count;
+    }
+
+    template<typename T>
+    void define_constraint(glp_prob* prob, int row, const T& constraint, Matrix& matrix, bool with_names)
+    {
+      if (with_names && !constraint.name.empty()) {
         glp_set_row_name(prob, row, constraint.name.c_str());
+      }
 
-        const double constant = constraint.expression.constant();
+      set_row_range(prob, row, constraint.range, constraint.expression.constant());
 
-        switch (constraint.range.type) {
-          case VariableRange::Unbounded:
-            glp_set_row_bnds(prob, row, GLP_FR, Ignored, Ignored);
-            break;
-          case VariableRange::LowerBounded:
-            glp_set_row_bnds(prob, row, GLP_LO, constraint.range.lower - constant, Ignored);
-            break;
-          case VariableRange::UpperBounded:
-            glp_set_row_bnds(prob, row, GLP_UP, Ignored, constraint.range.upper - constant);
-            break;
-          case VariableRange::Bounded:
-            glp_set_row_bnds(prob, row, GLP_DB, constraint.range.lower - constant, constraint.range.upper - constant);
-            break;
-          case VariableRange::Fixed:
-            glp_set_row_bnds(prob, row, GLP_FX, constraint.range.lower - constant, constraint.range.upper - constant);
-            break;
-        }
+      for (const auto& term : constraint.expression.linear_terms()) {
+        assert(term.coefficient != 0.0);
+        const int variable_col = static_cast<int>(to_index(term.variable) + 1);
 
-        auto linear_terms = constraint.expression.linear_terms();
+        matrix.row_indices.push_back(row);
+        matrix.col_indices.push_back(variable_col);
+        matrix.coefficients.push_back(term.coefficient);
+      }
+    }
+
+    // the non-linear constraints are replaced by the constraints of the
+    // linearization, the row of each constraint of the problem is stored in
+    // constraint_rows
+    template<typename T, typename L>
+    void define_constraints(glp_prob* prob, const std::vector<T>& constraints, const L& linearization, Matrix& matrix, std::vector<int>& constraint_rows, bool with_names)
+    {
+      const auto linear_count = std::count_if(constraints.begin(), constraints.end(), [](const T& constraint) {
+        return constraint.expression.is_linear();
+      });
 
-        for (auto& term : linear_terms) {
-          assert(term.coefficient != 0.0);
-          const int variable_col = static_cast<int>(to_index(term.variable) + 1);
+      const std::size_t constraint_count = static_cast<std::size_t>(linear_count) + linearization.constraints.size();
+      glp_add_rows(prob, static_cast<int>(constraint_count));
 
-          matrix.row_indices.push_back(row);
-          matrix.col_indices.push_back(variable_col);
-          matrix.coefficients.push_back(term.coefficient);
+      constraint_rows.assign(constraints.size(), 0);
+      int row = 1;
+
+      for (std::size_t index = 0; index < constraints.size(); ++index) {
+        if (constraints[index].expression.is_linear()) {
+          define_constraint(prob, row, constraints[index], matrix, with_names);
+          constraint_rows[index] = row;
+          ++row;
+        }
+      }
+
+      for (std::size_t index = 0; index < linearization.constraints.size(); ++index) {
+        define_constraint(prob, row, linearization.constraints[index], matrix, with_names);
+
+        if (const std::size_t origin = linearization.origins[index]; origin < constraint_rows.size()) {
+          constraint_rows[origin] = row;
         }
 
         ++row;
       }
     }
 
+    // number of nonzero coefficients in the linear constraints
     template<typename T>
-    Solution solve_mip(glp_prob* prob, const SolverConfig& config, const std::vector<T>& variables)
+    std::size_t count_nonzeros(const std::vector<T>& constraints)
+    {
+      std::size_t nonzero_count = 0;
+
+      for (const auto& constraint : constraints) {
+        if (constraint.expression.is_linear()) {
+          nonzero_count += constraint.expression.linear_terms().size();
+        }
+      }
+
+      return nonzero_count;
+    }
+
+    // load a problem and its linearization, returns the number of columns
+    template<typename V, typename C, typename O, typename L>
+    std::size_t load_problem(glp_prob* prob, const std::vector<V>& variables, const std::vector<C>& constraints, const O& objective, const L& linearization, std::vector<int>& constraint_rows, bool with_names)
+    {
+      define_objective(prob, objective.sense);
+
+      if (with_names) {
+        glp_set_obj_name(prob, objective.name.c_str());
+      }
+
+      const std::size_t variable_count = define_variables(prob, variables, linearization.variables, objective, with_names);
+
+      // the expressions are normalized, so the matrix has no duplicate
+      Matrix matrix(count_nonzeros(constraints) + count_nonzeros(linearization.constraints));
+      define_constraints(prob, constraints, linearization, matrix, constraint_rows, with_names);
+      glp_load_matrix(prob, matrix.size(), matrix.row_indices.data(), matrix.col_indices.data(), matrix.coefficients.data());
+
+      return variable_count;
+    }
+
+    int time_limit(const SolverConfig& config)
+    {
+      return (config.timeout != std::chrono::milliseconds::max()) ? static_cast<int>(config.timeout.count()) : std::numeric_limits<int>::max();
+    }
+
+    void init_simplex_parameters(glp_smcp& parameters, const SolverConfig& config)
+    {
+      glp_init_smcp(&parameters);
+
+      parameters.msg_lev = config.verbose ? GLP_MSG_ALL : GLP_MSG_OFF;
+      parameters.presolve = config.presolve ? GLP_ON : GLP_OFF;
+      parameters.tm_lim = time_limit(config);
+    }
+
+    int to_branching_technique(Branching branching)
+    {
+      switch (branching) {
+        case Branching::FirstFractional:
+          return GLP_BR_FFV;
+        case Branching::LastFractional:
+          return GLP_BR_LFV;
+        case Branching::MostFractional:
+          return GLP_BR_MFV;
+        case Branching::DriebeckTomlin:
+          return GLP_BR_DTH;
+      }
+
+      assert(false);
+      return GLP_BR_DTH;
+    }
+
+    int to_backtracking_technique(Backtracking backtracking)
+    {
+      switch (backtracking) {
+        case Backtracking::DepthFirst:
+          return GLP_BT_DFS;
+        case Backtracking::BreadthFirst:
+          return GLP_BT_BFS;
+        case Backtracking::BestLocalBound:
+          return GLP_BT_BLB;
+        case Backtracking::BestProjection:
+          return GLP_BT_BPH;
+      }
+
+      assert(false);
+      return GLP_BT_BLB;
+    }
+
+    void stop_callback(glp_tree* tree, void* info)
+    {
+      const auto* stop = static_cast<const std::atomic<bool>*>(info);
+
+      if (stop->load(std::memory_order_relaxed)) {
+        glp_ios_terminate(tree);
+      }
+    }
+
+    Solution solve_mip(glp_prob* prob, const SolverConfig& config, std::size_t variable_count)
     {
+      if (!config.presolve) {
+        // without the presolver, glp_intopt starts from an optimal basis of
+        // the LP relaxation
+        glp_smcp simplex_parameters;
+        init_simplex_parameters(simplex_parameters, config);
+
+        if (glp_simplex(prob, &simplex_parameters) != 0) {
+          return { SolutionStatus::Error };
+        }
+
+        if (auto status = glp_get_status(prob); status != GLP_OPT) {
+          return { to_solver_status(status) };
+        }
+      }
+
       glp_iocp parameters;
       glp_init_iocp(&parameters);
 
       parameters.msg_lev = config.verbose ? GLP_MSG_ALL : GLP_MSG_OFF;
+      parameters.br_tech = to_branching_technique(config.branching);
+      parameters.bt_tech = to_backtracking_technique(config.backtracking);
       parameters.presolve = config.presolve ? GLP_ON : GLP_OFF;
-      parameters.tm_lim = (config.timeout != std::chrono::milliseconds::max()) ? static_cast<int>(config.timeout.count()) : std::numeric_limits<int>::max();
+      parameters.tm_lim = time_limit(config);
+
+      if (config.stop != nullptr) {
+        parameters.cb_func = stop_callback;
+        parameters.cb_info = const_cast<std::atomic<bool>*>(config.stop); // NOLINT
+      }
 
       const int ret = glp_intopt(prob, &parameters);
 
@@ -162,31 +497,33 @@ namespace lqp {
         glp_print_mip(prob, config.solution_output.string().c_str());
       }
 
-      if (ret == 0) {
+      // when the search is interrupted, the best integer solution is kept
+      if (ret == 0 || ret == GLP_ETMLIM || ret == GLP_ESTOP) {
         auto status = to_solver_status(glp_mip_status(prob));
-        Solution solution(status);
 
         if (status == SolutionStatus::Optimal || status == SolutionStatus::Feasible) {
-          for (std::size_t variable_index = 0; variable_index < variables.size(); ++variable_index) {
-            solution.set_value(VariableId{ variable_index }, glp_mip_col_val(prob, static_cast<int>(variable_index + 1)));
+          std::vector<double> values(variable_count);
+
+          for (std::size_t variable_index = 0; variable_index < variable_count; ++variable_index) {
+            values[variable_index] = glp_mip_col_val(prob, static_cast<int>(variable_index + 1));
           }
+
+          return { status, std::move(values) };
         }
 
-        return solution;
+        if (ret == 0) {
+          return { status };
+        }
       }
 
       return { SolutionStatus::Error };
     }
 
-    template<typename T>
-    Solution solve_simplex(glp_prob* prob, const SolverConfig& config, const std::vector<T>& variables)
+    Solution solve_simplex(glp_prob* prob, const SolverConfig& config, std::size_t variable_count, int method = GLP_PRIMAL)
     {
       glp_smcp parameters;
-      glp_init_smcp(&parameters);
-
-      parameters.msg_lev = config.verbose ? GLP_MSG_ALL : GLP_MSG_OFF;
-      parameters.presolve = config.presolve ? GLP_ON : GLP_OFF;
-      parameters.tm_lim = (config.timeout != std::chrono::milliseconds::max()) ? static_cast<int>(config.timeout.count()) : std::numeric_limits<int>::max();
+      init_simplex_parameters(parameters, config);
+      parameters.meth = method;
 
       const int ret = glp_simplex(prob, &parameters);
 
@@ -196,102 +533,354 @@ namespace lqp {
 
       if (ret == 0) {
         auto status = to_solver_status(glp_get_status(prob));
-        Solution solution(status);
 
         if (status == SolutionStatus::Optimal || status == SolutionStatus::Feasible) {
-          for (std::size_t variable_index = 0; variable_index < variables.size(); ++variable_index) {
-            solution.set_value(VariableId{ variable_index }, glp_get_col_prim(prob, static_cast<int>(variable_index + 1)));
+          std::vector<double> values(variable_count);
+
+          for (std::size_t variable_index = 0; variable_index < variable_count; ++variable_index) {
+            values[variable_index] = glp_get_col_prim(prob, static_cast<int>(variable_index + 1));
+          }
+
+          return { status, std::move(values) };
+        }
+
+        return { status };
+      }
+
+      return { SolutionStatus::Error };
+    }
+
+    // the interior point method of glpk has no crossover, the solution is
+    // not basic
+    Solution solve_interior(glp_prob* prob, const SolverConfig& config, std::size_t variable_count)
+    {
+      glp_iptcp parameters;
+      glp_init_iptcp(&parameters);
+
+      parameters.msg_lev = config.verbose ? GLP_MSG_ALL : GLP_MSG_OFF;
+      parameters.ord_alg = GLP_ORD_AMD;
+
+      const int ret = glp_interior(prob, &parameters);
+
+      if (!config.solution_output.empty()) {
+        glp_print_ipt(prob, config.solution_output.string().c_str());
+      }
+
+      if (ret == 0) {
+        auto status = to_solver_status(glp_ipt_status(prob));
+
+        if (status == SolutionStatus::Optimal || status == SolutionStatus::Feasible) {
+          std::vector<double> values(variable_count);
+
+          for (std::size_t variable_index = 0; variable_index < variable_count; ++variable_index) {
+            values[variable_index] = glp_ipt_col_prim(prob, static_cast<int>(variable_index + 1));
           }
+
+          return { status, std::move(values) };
         }
 
-        return solution;
+        return { status };
       }
 
       return { SolutionStatus::Error };
     }
 
+    struct ProblemDeleter {
+      void operator()(glp_prob* prob) const
+      {
+        glp_delete_prob(prob);
+      }
+    };
+
+  }
+
+  /*
+   * GlpkSession
+   */
+
+  struct GlpkSession::State {
+    std::unique_ptr<glp_prob, ProblemDeleter> prob;
+    std::size_t variable_count = 0;
+    std::vector<int> constraint_rows;     // 0 when the constraint has been removed
+    std::vector<double> constraint_constants;
+  };
+
+  GlpkSession::GlpkSession() = default;
+  GlpkSession::~GlpkSession() = default;
+
+  GlpkSession::GlpkSession(GlpkSession&& other) noexcept = default;
+  GlpkSession& GlpkSession::operator=(GlpkSession&& other) noexcept = default;
+
+  bool GlpkSession::loaded() const
+  {
+    return m_state != nullptr;
+  }
+
+  void GlpkSession::set_variable_range(VariableId variable, VariableRange range)
+  {
+    assert(loaded());
+    assert(to_index(variable) < m_state->variable_count);
+    set_col_range(m_state->prob.get(), static_cast<int>(to_index(variable) + 1), range);
+  }
+
+  void GlpkSession::set_objective_coefficient(VariableId variable, double coefficient)
+  {
+    assert(loaded());
+    assert(to_index(variable) < m_state->variable_count);
+    glp_set_obj_coef(m_state->prob.get(), static_cast<int>(to_index(variable) + 1), coefficient);
+  }
+
+  void GlpkSession::set_constraint_range(ConstraintId constraint, VariableRange range)
+  {
+    assert(loaded());
+    assert(constraint.index < m_state->constraint_rows.size());
+    const int row = m_state->constraint_rows[constraint.index];
+    assert(row > 0);
+    set_row_range(m_state->prob.get(), row, range, m_state->constraint_constants[constraint.index]);
+  }
+
+  std::optional<ConstraintId> GlpkSession::add_constraint(Inequality inequality, std::string name)
+  {
+    assert(loaded());
+    QExpr& expression = inequality.expression;
+    expression.finalize();
+
+    if (!expression.is_linear()) {
+      return std::nullopt;
+    }
+
+    glp_prob* prob = m_state->prob.get();
+
+    // a new row is basic, so the current basis stays valid
+    const int row = glp_add_rows(prob, 1);
+    glp_set_row_name(prob, row, name.c_str());
+    set_row_range(prob, row, to_range(inequality.op), expression.constant());
+
+    std::vector<int> cols = { 0 };
+    std::vector<double> coefficients = { 0.0 };
+
+    for (const auto& term : expression.linear_terms()) {
+      assert(to_index(term.variable) < m_state->variable_count);
+      cols.push_back(static_cast<int>(to_index(term.variable) + 1));
+      coefficients.push_back(term.coefficient);
+    }
+
+    glp_set_mat_row(prob, row, static_cast<int>(cols.size() - 1), cols.data(), coefficients.data());
+
+    const std::size_t index = m_state->constraint_rows.size();
+    m_state->constraint_rows.push_back(row);
+    m_state->constraint_constants.push_back(expression.constant());
+    return ConstraintId{ index };
   }
 
+  void GlpkSession::remove_constraint(ConstraintId constraint)
+  {
+    assert(loaded());
+    assert(constraint.index < m_state->constraint_rows.size());
+    const int row = m_state->constraint_rows[constraint.index];
+
+    if (row == 0) {
+      return;
+    }
+
+    const int rows[] = { 0, row };
+    glp_del_rows(m_state->prob.get(), 1, rows);
+
+    // glpk renumbers the following rows
+    for (int& constraint_row : m_state->constraint_rows) {
+      if (constraint_row > row) {
+        --constraint_row;
+      }
+    }
+
+    m_state->constraint_rows[constraint.index] = 0;
+  }
+
+  Solution GlpkSession::solve(const SolverConfig& config)
+  {
+    if (!loaded()) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    glp_prob* prob = m_state->prob.get();
+
+    // the removal of a non-basic row invalidates the basis, in this case
+    // the solve restarts from an advanced basis
+    if (glp_bf_exists(prob) == 0 && glp_warm_up(prob) != 0) {
+      glp_adv_basis(prob, 0);
+    }
+
+    if (!config.problem_output.empty()) {
+      glp_write_lp(prob, nullptr, config.problem_output.string().c_str());
+    }
+
+    if (config.use_mip) {
+      return solve_mip(prob, config, m_state->variable_count);
+    }
+
+    // the dual simplex is the natural choice after a change of the bounds
+    // or of the right-hand sides
+    return solve_simplex(prob, config, m_state->variable_count, GLP_DUALP);
+  }
+
+  /*
+   * GlpkSolver
+   */
+
   bool GlpkSolver::available() const
   {
     return true;
   }
 
+  bool GlpkSolver::thread_safe()
+  {
+    return glp_config("TLS") != nullptr;
+  }
+
+  void GlpkSolver::release_thread_resources()
+  {
+    glp_free_env();
+  }
+
   Solution GlpkSolver::solve(const Problem& problem, const SolverConfig& config)
   {
-    Problem linear_problem = problem;
+    // the problem is borrowed, only the linearization of the non-linear
+    // constraints is computed
 
-    if (!linear_problem.is_linear()) {
-      auto maybe_linear_problem = problem.linearize();
+    if (!objective(problem).expression.is_linear()) {
+      return { SolutionStatus::NotSolved };
+    }
 
-      if (!maybe_linear_problem) {
-        return { SolutionStatus::NotSolved };
-      }
+    const auto maybe_linearization = linearization(problem);
 
-      linear_problem = *maybe_linear_problem;
+    if (!maybe_linearization) {
+      return { SolutionStatus::NotSolved };
     }
 
-    const std::unique_ptr<glp_prob, decltype(&glp_delete_prob)> unique_problem(glp_create_prob(), &glp_delete_prob);
+    const std::unique_ptr<glp_prob, ProblemDeleter> unique_problem(glp_create_prob());
     glp_prob* prob = unique_problem.get();
 
-    Matrix matrix;
+    std::vector<int> constraint_rows;
+    const std::size_t variable_count = load_problem(prob, variables(problem), constraints(problem), objective(problem), *maybe_linearization, constraint_rows, needs_names(config));
 
-    // first element is not used by glpk
-    matrix.row_indices.push_back(0);
-    matrix.col_indices.push_back(0);
-    matrix.coefficients.push_back(0.0);
+    if (!config.problem_output.empty()) {
+      glp_write_lp(prob, nullptr, config.problem_output.string().c_str());
+    }
 
-    /*
-     * objective
-     */
+    if (config.use_mip) {
+      return solve_mip(prob, config, variable_count);
+    }
 
-    auto raw_objective = objective(linear_problem);
+    if (config.algorithm == Algorithm::InteriorPoint) {
+      return solve_interior(prob, config, variable_count);
+    }
 
-    glp_set_obj_name(prob, raw_objective.name.c_str());
+    return solve_simplex(prob, config, variable_count);
+  }
 
-    switch (raw_objective.sense) {
-      case Sense::Maximize:
-        glp_set_obj_dir(prob, GLP_MAX);
-        break;
-      case Sense::Minimize:
-        glp_set_obj_dir(prob, GLP_MIN);
-        break;
+  Solution GlpkSolver::solve(const CompiledProblem& problem, const SolverConfig& config)
+  {
+    if (problem.has_quadratic_objective()) {
+      return { SolutionStatus::NotSolved };
     }
 
-    /*
-     * cols (variables)
-     */
+    const std::unique_ptr<glp_prob, ProblemDeleter> unique_problem(glp_create_prob());
+    glp_prob* prob = unique_problem.get();
 
-    auto raw_variables = variables(linear_problem);
-    define_variables(prob, raw_variables, raw_objective);
+    load_compiled_problem(prob, problem, needs_names(config));
 
-    /*
-     * rows (constraints)
-     */
+    if (!config.problem_output.empty()) {
+      glp_write_lp(prob, nullptr, config.problem_output.string().c_str());
+    }
 
-    auto raw_constraints = constraints(linear_problem);
-    define_constraints(prob, raw_constraints, matrix);
+    if (config.use_mip) {
+      return solve_mip(prob, config, problem.variable_count());
+    }
 
-    /*
-     * matrix
-     */
+    if (config.algorithm == Algorithm::InteriorPoint) {
+      return solve_interior(prob, config, problem.variable_count());
+    }
 
-    assert(glp_check_dup(static_cast<int>(raw_constraints.size()), static_cast<int>(raw_variables.size()), static_cast<int>(matrix.coefficients.size() - 1), matrix.row_indices.data(), matrix.col_indices.data()) == 0);
-    glp_load_matrix(prob, static_cast<int>(matrix.coefficients.size() - 1), matrix.row_indices.data(), matrix.col_indices.data(), matrix.coefficients.data());
+    return solve_simplex(prob, config, problem.variable_count());
+  }
 
-    if (!config.problem_output.empty()) {
-      glp_write_lp(prob, nullptr, config.problem_output.string().c_str());
+  std::vector<Solution> GlpkSolver::solve_batch(const std::vector<Problem>& problems, const SolverConfig& config, std::size_t worker_count)
+  {
+    SolverConfig batch_config = config;
+    batch_config.problem_output.clear();
+    batch_config.solution_output.clear();
+
+    std::vector<Solution> solutions(problems.size(), Solution(SolutionStatus::NotSolved));
+
+    if (worker_count == 0) {
+      worker_count = std::max(std::thread::hardware_concurrency(), 1u);
     }
 
-    /*
-     * solve
-     */
+    worker_count = std::min(worker_count, problems.size());
 
-    if (config.use_mip) {
-      return solve_mip(prob, config, raw_variables);
+    // without thread local storage, glpk has a single global environment
+    if (worker_count <= 1 || !thread_safe()) {
+      for (std::size_t index = 0; index < problems.size(); ++index) {
+        solutions[index] = solve(problems[index], batch_config);
+      }
+
+      return solutions;
+    }
+
+    std::atomic<std::size_t> next_index = 0;
+
+    // each worker keeps its glpk environment for all its problems
+    auto worker = [&]() {
+      GlpkSolver solver;
+
+      for (std::size_t index = next_index++; index < problems.size(); index = next_index++) {
+        solutions[index] = solver.solve(problems[index], batch_config);
+      }
+
+      release_thread_resources();
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(worker_count);
+
+    for (std::size_t i = 0; i < worker_count; ++i) {
+      workers.emplace_back(worker);
+    }
+
+    for (std::thread& thread : workers) {
+      thread.join();
+    }
+
+    return solutions;
+  }
+
+  GlpkSession GlpkSolver::open(const Problem& problem)
+  {
+    GlpkSession session;
+
+    if (!objective(problem).expression.is_linear()) {
+      return session;
+    }
+
+    const auto maybe_linearization = linearization(problem);
+
+    if (!maybe_linearization) {
+      return session;
+    }
+
+    auto state = std::make_unique<GlpkSession::State>();
+    state->prob.reset(glp_create_prob());
+    state->variable_count = load_problem(state->prob.get(), variables(problem), constraints(problem), objective(problem), *maybe_linearization, state->constraint_rows, true);
+
+    const auto& raw_constraints = constraints(problem);
+    state->constraint_constants.reserve(raw_constraints.size());
+
+    for (const auto& constraint : raw_constraints) {
+      state->constraint_constants.push_back(constraint.expression.constant());
     }
 
-    return solve_simplex(prob, config, raw_variables);
+    session.m_state = std::move(state);
+    return session;
   }
 
 }
@@ -0,0 +1,836 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include <lqp/InteriorPointSolver.h>
+// clang-format on
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <numeric>
+#include <thread>
+
+#include <lqp/Problem.h>
+#include <lqp/SimplexSolver.h>
+
+#include "SimplexEngine.h"
+#include "SparseCholesky.h"
+
+namespace lqp {
+
+  namespace {
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+
+    constexpr std::size_t IterationLimit = 200;
+    constexpr double Tolerance = 1e-8;
+    constexpr double StepFactor = 0.9995;
+    constexpr double PrimalRegularization = 1e-8; // for the free variables
+    constexpr double DualRegularization = 1e-10;
+    constexpr double DivergenceLimit = 1e12;
+    constexpr std::size_t ScalingIterations = 10;
+
+    struct InteriorPointLimits {
+      std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+      const std::atomic<bool>* stop = nullptr;
+      bool verbose = false;
+    };
+
+    double infinity_norm(const std::vector<double>& values)
+    {
+      double norm = 0.0;
+
+      for (const double value : values) {
+        norm = std::max(norm, std::abs(value));
+      }
+
+      return norm;
+    }
+
+    // Mehrotra predictor-corrector on min c^T v subject to [A -I] v = 0 and
+    // l <= v <= u, where v are the variables of the problem followed by one
+    // slack per row that has a finite bound. The bounds are always strictly
+    // satisfied by the iterates. The matrix is scaled with a Ruiz
+    // equilibration: A is replaced with R A C.
+    class InteriorPointEngine {
+    public:
+      InteriorPointEngine(const CompiledProblem& problem, std::size_t thread_count);
+
+      // Optimal, Undefined when a limit is reached, or Error when the method
+      // does not converge
+      SolutionStatus solve(const InteriorPointLimits& limits);
+
+      std::vector<double> primal_values() const;
+      // a basis for the simplex, with the variables far from their bounds
+      // in the basis
+      std::vector<BasisStatus> crossover_basis() const;
+
+    private:
+      bool has_lower(std::size_t index) const
+      {
+        return m_lower[index] != -Infinity;
+      }
+
+      bool has_upper(std::size_t index) const
+      {
+        return m_upper[index] != Infinity;
+      }
+
+      bool is_fixed(std::size_t index) const
+      {
+        return m_lower[index] == m_upper[index];
+      }
+
+      void initialize();
+      void multiply(const std::vector<double>& v, std::vector<double>& result) const;            // [A -I] v
+      void multiply_transposed(const std::vector<double>& y, std::vector<double>& result) const; // [A -I]^T y
+      void compute_theta();
+      void build_normal_matrix();
+      bool solve_newton(const std::vector<double>& rxl, const std::vector<double>& rxu);
+      double primal_step() const;
+      double dual_step() const;
+      double complementarity() const;
+
+      std::size_t m_variable_count = 0;
+      std::size_t m_constraint_count = 0;
+      std::vector<std::size_t> m_active_rows; // the compiled rows with a finite bound
+      std::size_t m_total_count = 0;
+      std::size_t m_thread_count = 1;
+
+      double m_sign = 1.0;
+      std::vector<double> m_original_lower;
+      std::vector<double> m_original_upper;
+
+      // scaled A, by rows and by columns
+      std::vector<std::size_t> m_row_starts;
+      std::vector<uint32_t> m_row_columns;
+      std::vector<double> m_row_values;
+      std::vector<std::size_t> m_column_starts;
+      std::vector<uint32_t> m_column_rows;
+      std::vector<double> m_column_values;
+      std::vector<double> m_row_scaling;
+      std::vector<double> m_column_scaling;
+
+      std::vector<double> m_cost;
+      std::vector<double> m_lower;
+      std::vector<double> m_upper;
+
+      std::vector<double> m_v;
+      std::vector<double> m_y;
+      std::vector<double> m_zl;
+      std::vector<double> m_zu;
+
+      std::vector<double> m_theta;
+      std::vector<double> m_rb;
+      std::vector<double> m_rc;
+
+      // Newton direction
+      std::vector<double> m_dv;
+      std::vector<double> m_dy;
+      std::vector<double> m_dzl;
+      std::vector<double> m_dzu;
+
+      // A Theta A^T + diagonal, lower triangle by columns
+      details::SparseColumns m_normal;
+      details::SparseCholesky m_cholesky;
+      std::vector<double> m_work;
+    };
+
+    InteriorPointEngine::InteriorPointEngine(const CompiledProblem& problem, std::size_t thread_count)
+    : m_variable_count(problem.variable_count())
+    , m_constraint_count(problem.constraint_count())
+    , m_thread_count(thread_count)
+    , m_sign(problem.sense() == Sense::Maximize ? -1.0 : 1.0)
+    , m_original_lower(problem.variable_lower_bounds())
+    , m_original_upper(problem.variable_upper_bounds())
+    {
+      const std::size_t n = m_variable_count;
+      const auto& constraint_lower = problem.constraint_lower_bounds();
+      const auto& constraint_upper = problem.constraint_upper_bounds();
+
+      // the free rows are dropped
+
+      m_row_starts.push_back(0);
+
+      for (std::size_t row = 0; row < m_constraint_count; ++row) {
+        if (constraint_lower[row] == -Infinity && constraint_upper[row] == Infinity) {
+          continue;
+        }
+
+        m_active_rows.push_back(row);
+
+        for (std::size_t p = problem.row_starts()[row]; p < problem.row_starts()[row + 1]; ++p) {
+          m_row_columns.push_back(problem.column_indices()[p]);
+          m_row_values.push_back(problem.values()[p]);
+        }
+
+        m_row_starts.push_back(m_row_columns.size());
+      }
+
+      const std::size_t r = m_active_rows.size();
+      m_total_count = n + r;
+
+      // Ruiz equilibration
+
+      m_row_scaling.assign(r, 1.0);
+      m_column_scaling.assign(n, 1.0);
+      std::vector<double> row_factors(r);
+      std::vector<double> column_factors(n);
+
+      for (std::size_t iteration = 0; iteration < ScalingIterations; ++iteration) {
+        std::fill(row_factors.begin(), row_factors.end(), 0.0);
+        std::fill(column_factors.begin(), column_factors.end(), 0.0);
+
+        for (std::size_t i = 0; i < r; ++i) {
+          for (std::size_t p = m_row_starts[i]; p < m_row_starts[i + 1]; ++p) {
+            const double magnitude = std::abs(m_row_values[p]);
+            row_factors[i] = std::max(row_factors[i], magnitude);
+            column_factors[m_row_columns[p]] = std::max(column_factors[m_row_columns[p]], magnitude);
+          }
+        }
+
+        for (double& factor : row_factors) {
+          factor = factor > 0.0 ? 1.0 / std::sqrt(factor) : 1.0;
+        }
+
+        for (double& factor : column_factors) {
+          factor = factor > 0.0 ? 1.0 / std::sqrt(factor) : 1.0;
+        }
+
+        for (std::size_t i = 0; i < r; ++i) {
+          for (std::size_t p = m_row_starts[i]; p < m_row_starts[i + 1]; ++p) {
+            m_row_values[p] *= row_factors[i] * column_factors[m_row_columns[p]];
+          }
+
+          m_row_scaling[i] *= row_factors[i];
+        }
+
+        for (std::size_t j = 0; j < n; ++j) {
+          m_column_scaling[j] *= column_factors[j];
+        }
+      }
+
+      // column copy
+
+      m_column_starts.assign(n + 1, 0);
+
+      for (const uint32_t column : m_row_columns) {
+        ++m_column_starts[column + 1];
+      }
+
+      std::partial_sum(m_column_starts.begin(), m_column_starts.end(), m_column_starts.begin());
+      m_column_rows.resize(m_row_columns.size());
+      m_column_values.resize(m_row_columns.size());
+      std::vector<std::size_t> next(m_column_starts.begin(), m_column_starts.end() - 1);
+
+      for (std::size_t i = 0; i < r; ++i) {
+        for (std::size_t p = m_row_starts[i]; p < m_row_starts[i + 1]; ++p) {
+          const std::size_t q = next[m_row_columns[p]]++;
+          m_column_rows[q] = static_cast<uint32_t>(i);
+          m_column_values[q] = m_row_values[p];
+        }
+      }
+
+      // scaled costs and bounds
+
+      m_cost.assign(m_total_count, 0.0);
+      m_lower.resize(m_total_count);
+      m_upper.resize(m_total_count);
+
+      for (std::size_t j = 0; j < n; ++j) {
+        m_cost[j] = m_sign * problem.objective()[j] * m_column_scaling[j];
+        m_lower[j] = m_original_lower[j] / m_column_scaling[j];
+        m_upper[j] = m_original_upper[j] / m_column_scaling[j];
+      }
+
+      for (std::size_t i = 0; i < r; ++i) {
+        m_lower[n + i] = constraint_lower[m_active_rows[i]] * m_row_scaling[i];
+        m_upper[n + i] = constraint_upper[m_active_rows[i]] * m_row_scaling[i];
+      }
+
+      // pattern of the normal matrix, the rows that share a column
+
+      m_normal.clear(r);
+      std::vector<std::size_t> marks(r, std::size_t(-1));
+      std::vector<std::size_t> rows;
+
+      for (std::size_t k = 0; k < r; ++k) {
+        rows.assign(1, k);
+        marks[k] = k;
+
+        for (std::size_t p = m_row_starts[k]; p < m_row_starts[k + 1]; ++p) {
+          const std::size_t j = m_row_columns[p];
+
+          for (std::size_t q = m_column_starts[j]; q < m_column_starts[j + 1]; ++q) {
+            if (const std::size_t i = m_column_rows[q]; i > k && marks[i] != k) {
+              marks[i] = k;
+              rows.push_back(i);
+            }
+          }
+        }
+
+        std::sort(rows.begin(), rows.end());
+
+        for (const std::size_t i : rows) {
+          m_normal.push(i, 0.0);
+        }
+
+        m_normal.finish_column();
+      }
+
+      m_cholesky.analyze(m_normal);
+    }
+
+    void InteriorPointEngine::initialize()
+    {
+      m_v.resize(m_total_count);
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        const double lower = m_lower[j];
+        const double upper = m_upper[j];
+
+        if (has_lower(j) && has_upper(j)) {
+          if (upper - lower <= 2.0) {
+            m_v[j] = 0.5 * (lower + upper);
+          } else {
+            m_v[j] = std::clamp(0.0, lower + 1.0, upper - 1.0);
+          }
+        } else if (has_lower(j)) {
+          m_v[j] = std::max(lower + 1.0, 0.0);
+        } else if (has_upper(j)) {
+          m_v[j] = std::min(upper - 1.0, 0.0);
+        } else {
+          m_v[j] = 0.0;
+        }
+      }
+
+      m_y.assign(m_active_rows.size(), 0.0);
+      m_zl.assign(m_total_count, 0.0);
+      m_zu.assign(m_total_count, 0.0);
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        if (is_fixed(j)) {
+          continue;
+        }
+
+        if (has_lower(j)) {
+          m_zl[j] = 1.0;
+        }
+
+        if (has_upper(j)) {
+          m_zu[j] = 1.0;
+        }
+      }
+    }
+
+    void InteriorPointEngine::multiply(const std::vector<double>& v, std::vector<double>& result) const
+    {
+      const std::size_t r = m_active_rows.size();
+      result.resize(r);
+
+      for (std::size_t i = 0; i < r; ++i) {
+        double sum = -v[m_variable_count + i];
+
+        for (std::size_t p = m_row_starts[i]; p < m_row_starts[i + 1]; ++p) {
+          sum += m_row_values[p] * v[m_row_columns[p]];
+        }
+
+        result[i] = sum;
+      }
+    }
+
+    void InteriorPointEngine::multiply_transposed(const std::vector<double>& y, std::vector<double>& result) const
+    {
+      result.resize(m_total_count);
+
+      for (std::size_t j = 0; j < m_variable_count; ++j) {
+        double sum = 0.0;
+
+        for (std::size_t q = m_column_starts[j]; q < m_column_starts[j + 1]; ++q) {
+          sum += m_column_values[q] * y[m_column_rows[q]];
+        }
+
+        result[j] = sum;
+      }
+
+      for (std::size_t i = 0; i < m_active_rows.size(); ++i) {
+        result[m_variable_count + i] = -y[i];
+      }
+    }
+
+    void InteriorPointEngine::compute_theta()
+    {
+      m_theta.resize(m_total_count);
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        if (is_fixed(j)) {
+          m_theta[j] = 0.0;
+          continue;
+        }
+
+        double d = 0.0;
+
+        if (has_lower(j)) {
+          d += m_zl[j] / (m_v[j] - m_lower[j]);
+        }
+
+        if (has_upper(j)) {
+          d += m_zu[j] / (m_upper[j] - m_v[j]);
+        }
+
+        if (!has_lower(j) && !has_upper(j)) {
+          d = PrimalRegularization;
+        }
+
+        m_theta[j] = 1.0 / d;
+      }
+    }
+
+    // column k of A Theta A^T is the sum of theta_j a_kj a_j over the columns
+    // j of row k
+    void InteriorPointEngine::build_normal_matrix()
+    {
+      const std::size_t r = m_active_rows.size();
+      m_work.assign(r, 0.0);
+
+      for (std::size_t k = 0; k < r; ++k) {
+        for (std::size_t p = m_row_starts[k]; p < m_row_starts[k + 1]; ++p) {
+          const std::size_t j = m_row_columns[p];
+          const double factor = m_theta[j] * m_row_values[p];
+
+          if (factor == 0.0) {
+            continue;
+          }
+
+          for (std::size_t q = m_column_starts[j]; q < m_column_starts[j + 1]; ++q) {
+            if (const std::size_t i = m_column_rows[q]; i >= k) {
+              m_work[i] += factor * m_column_values[q];
+            }
+          }
+        }
+
+        m_work[k] += m_theta[m_variable_count + k] + DualRegularization;
+
+        for (std::size_t p = m_normal.starts[k]; p < m_normal.starts[k + 1]; ++p) {
+          m_normal.values[p] = m_work[m_normal.indices[p]];
+          m_work[m_normal.indices[p]] = 0.0;
+        }
+      }
+    }
+
+    // with D = Zl / Xl + Zu / Xu and Theta = D^-1:
+    //   (A Theta A^T) dy = rb + A Theta (rc - rxl / Xl + rxu / Xu)
+    //   dv = Theta (A^T dy - (rc - rxl / Xl + rxu / Xu))
+    bool InteriorPointEngine::solve_newton(const std::vector<double>& rxl, const std::vector<double>& rxu)
+    {
+      std::vector<double> reduced(m_total_count);
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        double value = m_rc[j];
+
+        if (!is_fixed(j)) {
+          if (has_lower(j)) {
+            value -= rxl[j] / (m_v[j] - m_lower[j]);
+          }
+
+          if (has_upper(j)) {
+            value += rxu[j] / (m_upper[j] - m_v[j]);
+          }
+        }
+
+        reduced[j] = value;
+      }
+
+      std::vector<double> scaled(m_total_count);
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        scaled[j] = m_theta[j] * reduced[j];
+      }
+
+      multiply(scaled, m_dy);
+
+      for (std::size_t i = 0; i < m_dy.size(); ++i) {
+        m_dy[i] += m_rb[i];
+      }
+
+      m_cholesky.solve(m_dy);
+      multiply_transposed(m_dy, m_dv);
+
+      m_dzl.assign(m_total_count, 0.0);
+      m_dzu.assign(m_total_count, 0.0);
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        m_dv[j] = m_theta[j] * (m_dv[j] - reduced[j]);
+
+        if (is_fixed(j)) {
+          continue;
+        }
+
+        if (has_lower(j)) {
+          m_dzl[j] = (rxl[j] - m_zl[j] * m_dv[j]) / (m_v[j] - m_lower[j]);
+        }
+
+        if (has_upper(j)) {
+          m_dzu[j] = (rxu[j] + m_zu[j] * m_dv[j]) / (m_upper[j] - m_v[j]);
+        }
+
+        if (!std::isfinite(m_dv[j]) || !std::isfinite(m_dzl[j]) || !std::isfinite(m_dzu[j])) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    double InteriorPointEngine::primal_step() const
+    {
+      double step = 1.0;
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        if (m_dv[j] < 0.0 && has_lower(j) && !is_fixed(j)) {
+          step = std::min(step, (m_v[j] - m_lower[j]) / -m_dv[j]);
+        } else if (m_dv[j] > 0.0 && has_upper(j) && !is_fixed(j)) {
+          step = std::min(step, (m_upper[j] - m_v[j]) / m_dv[j]);
+        }
+      }
+
+      return step;
+    }
+
+    double InteriorPointEngine::dual_step() const
+    {
+      double step = 1.0;
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        if (m_dzl[j] < 0.0) {
+          step = std::min(step, m_zl[j] / -m_dzl[j]);
+        }
+
+        if (m_dzu[j] < 0.0) {
+          step = std::min(step, m_zu[j] / -m_dzu[j]);
+        }
+      }
+
+      return step;
+    }
+
+    double InteriorPointEngine::complementarity() const
+    {
+      double sum = 0.0;
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        if (is_fixed(j)) {
+          continue;
+        }
+
+        if (has_lower(j)) {
+          sum += (m_v[j] - m_lower[j]) * m_zl[j];
+        }
+
+        if (has_upper(j)) {
+          sum += (m_upper[j] - m_v[j]) * m_zu[j];
+        }
+      }
+
+      return sum;
+    }
+
+    SolutionStatus InteriorPointEngine::solve(const InteriorPointLimits& limits)
+    {
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        if (m_lower[j] > m_upper[j]) {
+          return SolutionStatus::Error;
+        }
+      }
+
+      initialize();
+
+      std::size_t pair_count = 0;
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        if (!is_fixed(j)) {
+          pair_count += (has_lower(j) ? 1 : 0) + (has_upper(j) ? 1 : 0);
+        }
+      }
+
+      pair_count = std::max(pair_count, std::size_t(1));
+
+      const double cost_norm = infinity_norm(m_cost);
+      std::vector<double> rxl(m_total_count);
+      std::vector<double> rxu(m_total_count);
+      std::vector<double> affine_dv;
+      std::vector<double> affine_dzl;
+      std::vector<double> affine_dzu;
+
+      for (std::size_t iteration = 0; iteration < IterationLimit; ++iteration) {
+        // residuals rb = -A v and rc = c - A^T y - zl + zu
+
+        multiply(m_v, m_rb);
+
+        for (double& value : m_rb) {
+          value = -value;
+        }
+
+        multiply_transposed(m_y, m_rc);
+        double primal_objective = 0.0;
+
+        for (std::size_t j = 0; j < m_total_count; ++j) {
+          m_rc[j] = is_fixed(j) ? 0.0 : m_cost[j] - m_rc[j] - m_zl[j] + m_zu[j];
+          primal_objective += m_cost[j] * m_v[j];
+        }
+
+        const double mu = complementarity() / double(pair_count);
+        const double v_norm = infinity_norm(m_v);
+        const double primal_infeasibility = infinity_norm(m_rb) / (1.0 + v_norm);
+        const double dual_infeasibility = infinity_norm(m_rc) / (1.0 + cost_norm);
+        const double gap = mu * double(pair_count) / (1.0 + std::abs(primal_objective));
+
+        if (limits.verbose) {
+          std::printf("%4zu: obj = %17.9e pinf = %9.2e dinf = %9.2e gap = %9.2e\n", iteration, m_sign * primal_objective, primal_infeasibility, dual_infeasibility, gap);
+        }
+
+        if (primal_infeasibility <= Tolerance && dual_infeasibility <= Tolerance && gap <= Tolerance) {
+          return SolutionStatus::Optimal;
+        }
+
+        if (!std::isfinite(mu) || v_norm > DivergenceLimit || infinity_norm(m_y) > DivergenceLimit) {
+          return SolutionStatus::Error;
+        }
+
+        if (limits.stop != nullptr && limits.stop->load(std::memory_order_relaxed)) {
+          return SolutionStatus::Undefined;
+        }
+
+        if (limits.deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= limits.deadline) {
+          return SolutionStatus::Undefined;
+        }
+
+        compute_theta();
+        build_normal_matrix();
+        m_cholesky.factorize(m_normal.values, m_thread_count);
+
+        // predictor
+
+        for (std::size_t j = 0; j < m_total_count; ++j) {
+          rxl[j] = has_lower(j) ? -(m_v[j] - m_lower[j]) * m_zl[j] : 0.0;
+          rxu[j] = has_upper(j) ? -(m_upper[j] - m_v[j]) * m_zu[j] : 0.0;
+        }
+
+        if (!solve_newton(rxl, rxu)) {
+          return SolutionStatus::Error;
+        }
+
+        const double affine_primal_step = primal_step();
+        const double affine_dual_step = dual_step();
+        double affine_complementarity = 0.0;
+
+        for (std::size_t j = 0; j < m_total_count; ++j) {
+          if (is_fixed(j)) {
+            continue;
+          }
+
+          if (has_lower(j)) {
+            affine_complementarity += (m_v[j] - m_lower[j] + affine_primal_step * m_dv[j]) * (m_zl[j] + affine_dual_step * m_dzl[j]);
+          }
+
+          if (has_upper(j)) {
+            affine_complementarity += (m_upper[j] - m_v[j] - affine_primal_step * m_dv[j]) * (m_zu[j] + affine_dual_step * m_dzu[j]);
+          }
+        }
+
+        const double affine_mu = affine_complementarity / double(pair_count);
+        const double sigma = mu > 0.0 ? std::pow(affine_mu / mu, 3.0) : 0.0;
+
+        // corrector, with the second order term of the predictor
+
+        affine_dv.swap(m_dv);
+        affine_dzl.swap(m_dzl);
+        affine_dzu.swap(m_dzu);
+
+        for (std::size_t j = 0; j < m_total_count; ++j) {
+          if (has_lower(j)) {
+            rxl[j] += sigma * mu - affine_dv[j] * affine_dzl[j];
+          }
+
+          if (has_upper(j)) {
+            rxu[j] += sigma * mu + affine_dv[j] * affine_dzu[j];
+          }
+        }
+
+        if (!solve_newton(rxl, rxu)) {
+          return SolutionStatus::Error;
+        }
+
+        const double step_primal = std::min(1.0, StepFactor * primal_step());
+        const double step_dual = std::min(1.0, StepFactor * dual_step());
+
+        for (std::size_t j = 0; j < m_total_count; ++j) {
+          m_v[j] += step_primal * m_dv[j];
+          m_zl[j] += step_dual * m_dzl[j];
+          m_zu[j] += step_dual * m_dzu[j];
+        }
+
+        for (std::size_t i = 0; i < m_y.size(); ++i) {
+          m_y[i] += step_dual * m_dy[i];
+        }
+      }
+
+      return SolutionStatus::Error;
+    }
+
+    std::vector<double> InteriorPointEngine::primal_values() const
+    {
+      std::vector<double> values(m_variable_count);
+
+      for (std::size_t j = 0; j < m_variable_count; ++j) {
+        values[j] = std::clamp(m_v[j] * m_column_scaling[j], m_original_lower[j], m_original_upper[j]);
+      }
+
+      return values;
+    }
+
+    std::vector<BasisStatus> InteriorPointEngine::crossover_basis() const
+    {
+      std::vector<BasisStatus> basis(m_variable_count + m_constraint_count, BasisStatus::Basic);
+      std::vector<std::size_t> active_logicals(m_total_count);
+
+      for (std::size_t j = 0; j < m_variable_count; ++j) {
+        active_logicals[j] = j;
+      }
+
+      for (std::size_t i = 0; i < m_active_rows.size(); ++i) {
+        active_logicals[m_variable_count + i] = m_variable_count + m_active_rows[i];
+      }
+
+      // the ratio of the distance to the nearest bound and the dual slack of
+      // this bound, the largest ratios are in the basis
+      std::vector<double> scores(m_total_count);
+
+      for (std::size_t j = 0; j < m_total_count; ++j) {
+        if (is_fixed(j)) {
+          scores[j] = -1.0;
+        } else if (!has_lower(j) && !has_upper(j)) {
+          scores[j] = Infinity;
+        } else {
+          const double lower_distance = has_lower(j) ? m_v[j] - m_lower[j] : Infinity;
+          const double upper_distance = has_upper(j) ? m_upper[j] - m_v[j] : Infinity;
+          const double distance = std::min(lower_distance, upper_distance);
+          const double dual = lower_distance <= upper_distance ? m_zl[j] : m_zu[j];
+          scores[j] = distance / (distance + dual);
+        }
+      }
+
+      std::vector<std::size_t> order(m_total_count);
+      std::iota(order.begin(), order.end(), 0);
+      const std::size_t basic_count = m_active_rows.size();
+
+      std::nth_element(order.begin(), order.begin() + std::ptrdiff_t(basic_count), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+        return scores[lhs] > scores[rhs];
+      });
+
+      for (std::size_t k = basic_count; k < m_total_count; ++k) {
+        const std::size_t j = order[k];
+        BasisStatus status = BasisStatus::Free;
+
+        if (has_lower(j) && has_upper(j)) {
+          status = m_v[j] - m_lower[j] <= m_upper[j] - m_v[j] ? BasisStatus::AtLower : BasisStatus::AtUpper;
+        } else if (has_lower(j)) {
+          status = BasisStatus::AtLower;
+        } else if (has_upper(j)) {
+          status = BasisStatus::AtUpper;
+        }
+
+        basis[active_logicals[j]] = status;
+      }
+
+      return basis;
+    }
+
+  }
+
+  InteriorPointSolver::InteriorPointSolver(InteriorPointOptions options)
+  : m_options(options)
+  {
+  }
+
+  bool InteriorPointSolver::available() const
+  {
+    return true;
+  }
+
+  Solution InteriorPointSolver::solve(const Problem& problem, const SolverConfig& config)
+  {
+    const auto compiled = problem.compile();
+
+    if (!compiled) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    return solve(*compiled, config);
+  }
+
+  Solution InteriorPointSolver::solve(const CompiledProblem& problem, const SolverConfig& config)
+  {
+    if (problem.has_quadratic_objective()) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    const auto& categories = problem.variable_categories();
+
+    if (config.use_mip && std::any_of(categories.begin(), categories.end(), [](VariableCategory category) { return category != VariableCategory::Continuous; })) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    InteriorPointLimits limits;
+    limits.verbose = config.verbose;
+    limits.stop = config.stop;
+
+    if (config.timeout != std::chrono::milliseconds::max()) {
+      limits.deadline = std::chrono::steady_clock::now() + config.timeout;
+    }
+
+    std::size_t thread_count = m_options.thread_count;
+
+    if (thread_count == 0) {
+      thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    InteriorPointEngine engine(problem, thread_count);
+    const SolutionStatus status = engine.solve(limits);
+
+    if (status == SolutionStatus::Undefined) {
+      return { status };
+    }
+
+    if (status == SolutionStatus::Optimal && !m_options.crossover) {
+      return { status, engine.primal_values() };
+    }
+
+    // crossover, or the simplex decides a problem that the interior point
+    // method could not solve
+
+    details::SimplexEngine simplex(problem);
+
+    if (status == SolutionStatus::Optimal) {
+      simplex.set_basis(engine.crossover_basis());
+    }
+
+    details::SimplexOptions options;
+    options.verbose = config.verbose;
+    options.stop = config.stop;
+    options.deadline = limits.deadline;
+
+    const SolutionStatus simplex_status = simplex.solve(options);
+
+    if (simplex_status == SolutionStatus::Optimal) {
+      return { simplex_status, simplex.primal_values() };
+    }
+
+    return { simplex_status };
+  }
+
+}
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include "MappedFile.h"
+// clang-format on
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace lqp::details {
+
+#ifdef _WIN32
+
+  MappedFile::MappedFile(const std::filesystem::path& path)
+  {
+    m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (m_file == INVALID_HANDLE_VALUE) {
+      m_file = nullptr;
+      return;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(m_file, &size)) {
+      return;
+    }
+
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    m_open = true;
+
+    if (m_size == 0) {
+      return;
+    }
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (m_mapping == nullptr) {
+      m_open = false;
+      return;
+    }
+
+    m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    m_open = m_data != nullptr;
+  }
+
+  MappedFile::~MappedFile()
+  {
+    if (m_data != nullptr) {
+      UnmapViewOfFile(m_data);
+    }
+
+    if (m_mapping != nullptr) {
+      CloseHandle(m_mapping);
+    }
+
+    if (m_file != nullptr) {
+      CloseHandle(m_file);
+    }
+  }
+
+#else
+
+  MappedFile::MappedFile(const std::filesystem::path& path)
+  {
+    const int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd == -1) {
+      return;
+    }
+
+    struct stat info = {};
+
+    if (::fstat(fd, &info) == 0) {
+      m_size = static_cast<std::size_t>(info.st_size);
+      m_open = true;
+
+      if (m_size > 0) {
+        void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data == MAP_FAILED) {
+          m_open = false;
+        } else {
+          ::madvise(data, m_size, MADV_SEQUENTIAL);
+          m_data = static_cast<const char*>(data);
+        }
+      }
+    }
+
+    // the mapping stays valid after the file is closed
+    ::close(fd);
+  }
+
+  MappedFile::~MappedFile()
+  {
+    if (m_data != nullptr) {
+      ::munmap(const_cast<char*>(m_data), m_size);
+    }
+  }
+
+#endif
+
+  bool MappedFile::is_open() const
+  {
+    return m_open;
+  }
+
+  std::string_view MappedFile::content() const
+  {
+    return { m_data, m_size };
+  }
+
+}
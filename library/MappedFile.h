@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_MAPPED_FILE_H
+#define LQP_MAPPED_FILE_H
+
+#include <cstddef>
+
+#include <filesystem>
+#include <string_view>
+
+namespace lqp::details {
+
+  // read-only memory mapping of a whole file
+  class MappedFile {
+  public:
+    MappedFile(const std::filesystem::path& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&&) = delete;
+    ~MappedFile();
+
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&&) = delete;
+
+    bool is_open() const;
+    std::string_view content() const;
+
+  private:
+    bool m_open = false;
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+  };
+
+}
+
+#endif // LQP_MAPPED_FILE_H
@@ -0,0 +1,1597 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include <lqp/ModelReader.h>
+// clang-format on
+
+#include <cassert>
+#include <cctype>
+#include <cmath>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "MappedFile.h"
+
+namespace lqp {
+
+  namespace {
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+    constexpr double InfiniteBound = 1e30;
+    constexpr std::size_t Objective = std::size_t(-1);
+
+    bool iequals(std::string_view lhs, std::string_view rhs)
+    {
+      return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](char c0, char c1) {
+        return std::tolower(static_cast<unsigned char>(c0)) == std::tolower(static_cast<unsigned char>(c1));
+      });
+    }
+
+    bool is_space(char c)
+    {
+      return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+    }
+
+    std::string_view trim(std::string_view text)
+    {
+      while (!text.empty() && is_space(text.front())) {
+        text.remove_prefix(1);
+      }
+
+      while (!text.empty() && is_space(text.back())) {
+        text.remove_suffix(1);
+      }
+
+      return text;
+    }
+
+    std::optional<double> parse_number(std::string_view text)
+    {
+      bool negative = false;
+
+      if (!text.empty() && (text.front() == '+' || text.front() == '-')) {
+        negative = text.front() == '-';
+        text.remove_prefix(1);
+      }
+
+      if (text.empty()) {
+        return std::nullopt;
+      }
+
+      if (iequals(text, "inf") || iequals(text, "infinity")) {
+        return negative ? -Infinity : Infinity;
+      }
+
+      double value = 0.0;
+      const char* end = text.data() + text.size();
+      auto [pointer, error] = std::from_chars(text.data(), end, value);
+
+      if (error != std::errc() || pointer != end) {
+        return std::nullopt;
+      }
+
+      return negative ? -value : value;
+    }
+
+    double bound_value(double value)
+    {
+      if (value >= InfiniteBound) {
+        return Infinity;
+      }
+
+      if (value <= -InfiniteBound) {
+        return -Infinity;
+      }
+
+      return value;
+    }
+
+    VariableRange limits_range(double lower, double upper)
+    {
+      const bool has_lower = std::isfinite(lower);
+      const bool has_upper = std::isfinite(upper);
+
+      if (has_lower && has_upper) {
+        return lower == upper ? fixed(lower) : bounds(lower, upper);
+      }
+
+      if (has_lower) {
+        return lower_bound(lower);
+      }
+
+      if (has_upper) {
+        return upper_bound(upper);
+      }
+
+      return {};
+    }
+
+    /*
+     * ModelBuilder
+     */
+
+    struct Column {
+      std::string_view name;
+      VariableCategory category = VariableCategory::Continuous;
+      double lower = 0.0;
+      double upper = Infinity;
+      double cost = 0.0;
+    };
+
+    struct Row {
+      std::string_view name;
+      double lower = -Infinity;
+      double upper = Infinity;
+      bool quadratic = false;
+    };
+
+    struct Entry {
+      std::size_t row;
+      std::size_t column;
+      double value;
+    };
+
+    struct QuadraticEntry {
+      std::size_t row; // or Objective
+      std::size_t column0;
+      std::size_t column1;
+      double value;
+    };
+
+    // the data of a problem in the order of the file, the names are views
+    // of the content of the file
+    class ModelBuilder {
+    public:
+      std::size_t column(std::string_view name)
+      {
+        auto [iterator, inserted] = m_column_indices.try_emplace(name, m_columns.size());
+
+        if (inserted) {
+          m_columns.push_back({ name });
+        }
+
+        return iterator->second;
+      }
+
+      Column& column_data(std::size_t index)
+      {
+        return m_columns[index];
+      }
+
+      std::size_t add_row(std::string_view name, double lower, double upper)
+      {
+        m_rows.push_back({ name, lower, upper });
+        return m_rows.size() - 1;
+      }
+
+      Row& row_data(std::size_t index)
+      {
+        return m_rows[index];
+      }
+
+      std::size_t row_count() const
+      {
+        return m_rows.size();
+      }
+
+      void add_entry(std::size_t row, std::size_t column, double value)
+      {
+        if (row == Objective) {
+          m_columns[column].cost += value;
+        } else {
+          m_entries.push_back({ row, column, value });
+        }
+      }
+
+      void add_quadratic_entry(std::size_t row, std::size_t column0, std::size_t column1, double value)
+      {
+        if (row != Objective) {
+          m_rows[row].quadratic = true;
+        }
+
+        m_quadratic_entries.push_back({ row, column0, column1, value });
+      }
+
+      Sense sense = Sense::Minimize;
+      std::string_view objective_name;
+      double objective_constant = 0.0;
+
+      Problem build() const;
+
+    private:
+      std::unordered_map<std::string_view, std::size_t> m_column_indices;
+      std::vector<Column> m_columns;
+      std::vector<Row> m_rows;
+      std::vector<Entry> m_entries;
+      std::vector<QuadraticEntry> m_quadratic_entries;
+    };
+
+    Problem ModelBuilder::build() const
+    {
+      Problem problem;
+
+      for (const Column& column : m_columns) {
+        const VariableRange range = column.category == VariableCategory::Binary ? bounds(0.0, 1.0) : limits_range(column.lower, column.upper);
+        problem.add_variable(column.category, range, std::string(column.name));
+      }
+
+      // entries sorted by row, in the order of the file in a row
+
+      const std::size_t row_count = m_rows.size();
+      std::vector<std::size_t> row_starts(row_count + 1, 0);
+
+      for (const Entry& entry : m_entries) {
+        ++row_starts[entry.row + 1];
+      }
+
+      for (std::size_t row = 0; row < row_count; ++row) {
+        row_starts[row + 1] += row_starts[row];
+      }
+
+      std::vector<std::size_t> col_indices(m_entries.size());
+      std::vector<double> values(m_entries.size());
+      std::vector<std::size_t> positions(row_starts.begin(), row_starts.end() - 1);
+
+      for (const Entry& entry : m_entries) {
+        const std::size_t position = positions[entry.row]++;
+        col_indices[position] = entry.column;
+        values[position] = entry.value;
+      }
+
+      std::vector<std::vector<const QuadraticEntry*>> quadratic_rows(row_count);
+
+      for (const QuadraticEntry& entry : m_quadratic_entries) {
+        if (entry.row != Objective) {
+          quadratic_rows[entry.row].push_back(&entry);
+        }
+      }
+
+      // the linear rows are added in batches, the quadratic rows one by one
+
+      auto add_linear_rows = [&](std::size_t first, std::size_t last) {
+        if (first == last) {
+          return;
+        }
+
+        std::vector<std::size_t> batch_starts(row_starts.begin() + first, row_starts.begin() + last + 1);
+        const std::size_t offset = batch_starts.front();
+
+        for (std::size_t& start : batch_starts) {
+          start -= offset;
+        }
+
+        std::vector<double> lower;
+        std::vector<double> upper;
+        std::vector<std::string> names;
+
+        for (std::size_t row = first; row < last; ++row) {
+          lower.push_back(m_rows[row].lower);
+          upper.push_back(m_rows[row].upper);
+          names.emplace_back(m_rows[row].name);
+        }
+
+        if (first == 0 && last == row_count) {
+          problem.add_rows(batch_starts, col_indices, values, lower, upper, std::move(names));
+        } else {
+          const std::vector<std::size_t> batch_indices(col_indices.begin() + offset, col_indices.begin() + row_starts[last]);
+          const std::vector<double> batch_values(values.begin() + offset, values.begin() + row_starts[last]);
+          problem.add_rows(batch_starts, batch_indices, batch_values, lower, upper, std::move(names));
+        }
+      };
+
+      std::size_t first = 0;
+
+      for (std::size_t row = 0; row < row_count; ++row) {
+        const Row& data = m_rows[row];
+
+        if (!data.quadratic) {
+          continue;
+        }
+
+        add_linear_rows(first, row);
+        first = row + 1;
+
+        QExpr expression;
+        expression.reserve(row_starts[row + 1] - row_starts[row], quadratic_rows[row].size());
+
+        for (std::size_t k = row_starts[row]; k < row_starts[row + 1]; ++k) {
+          expression.add_term(values[k], VariableId{ col_indices[k] });
+        }
+
+        for (const QuadraticEntry* entry : quadratic_rows[row]) {
+          expression.add_term(entry->value, VariableId{ entry->column0 }, VariableId{ entry->column1 });
+        }
+
+        expression.finalize();
+
+        if (data.lower == data.upper) {
+          problem.add_constraint(expression == data.lower, std::string(data.name));
+        } else {
+          if (data.lower != -Infinity) {
+            problem.add_constraint(expression >= data.lower, std::string(data.name));
+          }
+
+          if (data.upper != Infinity) {
+            problem.add_constraint(expression <= data.upper, std::string(data.name));
+          }
+        }
+      }
+
+      add_linear_rows(first, row_count);
+
+      // objective
+
+      QExpr objective(objective_constant);
+      objective.reserve(m_columns.size(), m_quadratic_entries.size());
+
+      for (std::size_t index = 0; index < m_columns.size(); ++index) {
+        if (m_columns[index].cost != 0.0) {
+          objective.add_term(m_columns[index].cost, VariableId{ index });
+        }
+      }
+
+      for (const QuadraticEntry& entry : m_quadratic_entries) {
+        if (entry.row == Objective) {
+          objective.add_term(entry.value, VariableId{ entry.column0 }, VariableId{ entry.column1 });
+        }
+      }
+
+      problem.set_objective(sense, objective, std::string(objective_name));
+      return problem;
+    }
+
+    /*
+     * MPS
+     */
+
+    class MpsParser {
+    public:
+      MpsParser(std::string_view content, MpsFormat format)
+      : m_content(content)
+      , m_format(format)
+      {
+      }
+
+      std::optional<Problem> parse();
+
+    private:
+      enum class Section : uint8_t {
+        None,
+        ObjectiveSense,
+        Rows,
+        Columns,
+        Rhs,
+        Ranges,
+        Bounds,
+        QuadraticObjective,
+        QuadraticMatrix,
+        End,
+      };
+
+      // the fields of a data line, fields[0] is the first field (type)
+      using Fields = std::array<std::string_view, 6>;
+
+      bool parse_section(std::string_view line);
+      bool split_fields(std::string_view line, Fields& fields) const;
+
+      bool parse_row(const Fields& fields);
+      bool parse_column(const Fields& fields);
+      bool parse_rhs(const Fields& fields);
+      bool parse_range(const Fields& fields);
+      bool parse_bound(const Fields& fields);
+      bool parse_quadratic(const Fields& fields);
+
+      std::optional<std::size_t> find_row(std::string_view name) const;
+
+      std::string_view m_content;
+      MpsFormat m_format;
+      Section m_section = Section::None;
+      bool m_has_name = false;
+      bool m_has_rows = false;
+
+      ModelBuilder m_builder;
+      std::string_view m_objective_row;
+      std::unordered_map<std::string_view, std::size_t> m_row_indices;
+      std::unordered_set<std::string_view> m_free_rows; // other N rows, ignored
+      std::vector<char> m_row_types;
+      std::vector<double> m_rhs;
+      std::vector<double> m_ranges;
+
+      bool m_integer_marker = false;
+      std::string_view m_last_column_name;
+      std::size_t m_last_column = 0;
+    };
+
+    std::optional<Problem> MpsParser::parse()
+    {
+      std::string_view content = m_content;
+
+      while (!content.empty() && m_section != Section::End) {
+        const std::size_t end_of_line = content.find('\n');
+        std::string_view line = content.substr(0, end_of_line);
+        content.remove_prefix(end_of_line == std::string_view::npos ? content.size() : end_of_line + 1);
+
+        if (!line.empty() && line.back() == '\r') {
+          line.remove_suffix(1);
+        }
+
+        if (trim(line).empty() || line.front() == '*') {
+          continue;
+        }
+
+        if (!is_space(line.front())) {
+          if (!parse_section(line)) {
+            return std::nullopt;
+          }
+
+          continue;
+        }
+
+        Fields fields = {};
+
+        if (!split_fields(line, fields)) {
+          return std::nullopt;
+        }
+
+        bool valid = true;
+
+        switch (m_section) {
+          case Section::ObjectiveSense:
+            if (iequals(fields[0], "MAX") || iequals(fields[0], "MAXIMIZE")) {
+              m_builder.sense = Sense::Maximize;
+            } else if (iequals(fields[0], "MIN") || iequals(fields[0], "MINIMIZE")) {
+              m_builder.sense = Sense::Minimize;
+            } else {
+              valid = false;
+            }
+            break;
+          case Section::Rows:
+            valid = parse_row(fields);
+            break;
+          case Section::Columns:
+            valid = parse_column(fields);
+            break;
+          case Section::Rhs:
+            valid = parse_rhs(fields);
+            break;
+          case Section::Ranges:
+            valid = parse_range(fields);
+            break;
+          case Section::Bounds:
+            valid = parse_bound(fields);
+            break;
+          case Section::QuadraticObjective:
+          case Section::QuadraticMatrix:
+            valid = parse_quadratic(fields);
+            break;
+          default:
+            valid = false;
+            break;
+        }
+
+        if (!valid) {
+          return std::nullopt;
+        }
+      }
+
+      // an empty or truncated content is not valid
+      if (!m_has_name || !m_has_rows || m_section != Section::End) {
+        return std::nullopt;
+      }
+
+      // bounds of the rows
+
+      for (std::size_t row = 0; row < m_builder.row_count(); ++row) {
+        Row& data = m_builder.row_data(row);
+        const double rhs = m_rhs[row];
+        const double range = m_ranges[row];
+        const bool has_range = !std::isnan(range);
+
+        switch (m_row_types[row]) {
+          case 'L':
+            data.lower = has_range ? rhs - std::abs(range) : -Infinity;
+            data.upper = rhs;
+            break;
+          case 'G':
+            data.lower = rhs;
+            data.upper = has_range ? rhs + std::abs(range) : Infinity;
+            break;
+          case 'E':
+            data.lower = (has_range && range < 0.0) ? rhs + range : rhs;
+            data.upper = (has_range && range > 0.0) ? rhs + range : rhs;
+            break;
+          default:
+            assert(false);
+            break;
+        }
+      }
+
+      return m_builder.build();
+    }
+
+    bool MpsParser::parse_section(std::string_view line)
+    {
+      const std::size_t end_of_keyword = std::min(line.find_first_of(" \t"), line.size());
+      const std::string_view keyword = line.substr(0, end_of_keyword);
+      const std::string_view argument = trim(line.substr(end_of_keyword));
+
+      if (iequals(keyword, "NAME")) {
+        m_section = Section::None;
+        m_has_name = true;
+      } else if (iequals(keyword, "OBJSENSE")) {
+        m_section = Section::ObjectiveSense;
+
+        if (iequals(argument, "MAX") || iequals(argument, "MAXIMIZE")) {
+          m_builder.sense = Sense::Maximize;
+        } else if (!argument.empty() && !iequals(argument, "MIN") && !iequals(argument, "MINIMIZE")) {
+          return false;
+        }
+      } else if (iequals(keyword, "ROWS")) {
+        m_section = Section::Rows;
+        m_has_rows = true;
+      } else if (iequals(keyword, "COLUMNS")) {
+        m_section = Section::Columns;
+      } else if (iequals(keyword, "RHS")) {
+        m_section = Section::Rhs;
+      } else if (iequals(keyword, "RANGES")) {
+        m_section = Section::Ranges;
+      } else if (iequals(keyword, "BOUNDS")) {
+        m_section = Section::Bounds;
+      } else if (iequals(keyword, "QUADOBJ")) {
+        m_section = Section::QuadraticObjective;
+      } else if (iequals(keyword, "QMATRIX")) {
+        m_section = Section::QuadraticMatrix;
+      } else if (iequals(keyword, "ENDATA")) {
+        m_section = Section::End;
+      } else {
+        return false;
+      }
+
+      return true;
+    }
+
+    bool MpsParser::split_fields(std::string_view line, Fields& fields) const
+    {
+      if (m_format == MpsFormat::Fixed && m_section != Section::ObjectiveSense) {
+        static constexpr std::size_t Starts[] = { 1, 4, 14, 24, 39, 49 };
+        static constexpr std::size_t Ends[] = { 3, 12, 22, 36, 47, 61 };
+
+        for (std::size_t index = 0; index < fields.size(); ++index) {
+          if (Starts[index] < line.size()) {
+            fields[index] = trim(line.substr(Starts[index], Ends[index] - Starts[index]));
+          }
+        }
+
+        return true;
+      }
+
+      std::array<std::string_view, 7> tokens = {};
+      std::size_t count = 0;
+
+      for (;;) {
+        line = trim(line);
+
+        if (line.empty()) {
+          break;
+        }
+
+        if (count == tokens.size()) {
+          return false;
+        }
+
+        const std::size_t end_of_token = std::min(line.find_first_of(" \t"), line.size());
+        tokens[count++] = line.substr(0, end_of_token);
+        line.remove_prefix(end_of_token);
+      }
+
+      // the tokens are placed in the fields of the fixed format, the name
+      // of the set of the RHS, RANGES and BOUNDS sections is optional
+
+      switch (m_section) {
+        case Section::ObjectiveSense:
+        case Section::Rows:
+          std::copy_n(tokens.begin(), std::min<std::size_t>(count, 2), fields.begin());
+          return count == 1 || count == 2;
+        case Section::Columns:
+        case Section::QuadraticObjective:
+        case Section::QuadraticMatrix:
+          std::copy_n(tokens.begin(), std::min<std::size_t>(count, 5), fields.begin() + 1);
+          return count >= 3 && count <= 5;
+        case Section::Rhs:
+        case Section::Ranges:
+          if (count % 2 == 0) {
+            std::copy_n(tokens.begin(), std::min<std::size_t>(count, 4), fields.begin() + 2);
+          } else {
+            std::copy_n(tokens.begin(), std::min<std::size_t>(count, 5), fields.begin() + 1);
+          }
+
+          return count >= 2 && count <= 5;
+        case Section::Bounds:
+          {
+            if (count < 2) {
+              return false;
+            }
+
+            fields[0] = tokens[0];
+            const bool has_value = !(iequals(tokens[0], "FR") || iequals(tokens[0], "MI") || iequals(tokens[0], "PL") || iequals(tokens[0], "BV")) || count == 4;
+            const std::size_t expected = has_value ? 3 : 2;
+
+            if (count - 1 == expected) {
+              std::copy_n(tokens.begin() + 1, expected, fields.begin() + 1);
+            } else if (count - 1 == expected - 1) {
+              std::copy_n(tokens.begin() + 1, expected - 1, fields.begin() + 2);
+            } else {
+              return false;
+            }
+
+            return true;
+          }
+        default:
+          break;
+      }
+
+      return false;
+    }
+
+    bool MpsParser::parse_row(const Fields& fields)
+    {
+      const std::string_view type = fields[0];
+      const std::string_view name = fields[1];
+
+      if (type.size() != 1 || name.empty()) {
+        return false;
+      }
+
+      const char kind = static_cast<char>(std::toupper(static_cast<unsigned char>(type.front())));
+
+      if (kind == 'N') {
+        if (m_objective_row.empty()) {
+          m_objective_row = name;
+          m_builder.objective_name = name;
+        } else {
+          m_free_rows.insert(name);
+        }
+
+        return true;
+      }
+
+      if (kind != 'L' && kind != 'G' && kind != 'E') {
+        return false;
+      }
+
+      m_row_indices.emplace(name, m_builder.add_row(name, -Infinity, Infinity));
+      m_row_types.push_back(kind);
+      m_rhs.push_back(0.0);
+      m_ranges.push_back(std::numeric_limits<double>::quiet_NaN());
+      return true;
+    }
+
+    bool MpsParser::parse_column(const Fields& fields)
+    {
+      const std::string_view name = fields[1];
+
+      if (fields[2] == "'MARKER'") {
+        const std::string_view marker = fields[3].empty() ? fields[4] : fields[3];
+
+        if (marker == "'INTORG'") {
+          m_integer_marker = true;
+        } else if (marker == "'INTEND'") {
+          m_integer_marker = false;
+        } else {
+          return false;
+        }
+
+        return true;
+      }
+
+      // the entries of a column are contiguous
+      if (name != m_last_column_name || m_last_column_name.empty()) {
+        m_last_column = m_builder.column(name);
+        m_last_column_name = name;
+
+        if (m_integer_marker) {
+          m_builder.column_data(m_last_column).category = VariableCategory::Integer;
+        }
+      }
+
+      for (std::size_t index = 2; index + 1 < fields.size(); index += 2) {
+        if (fields[index].empty()) {
+          break;
+        }
+
+        const auto row = find_row(fields[index]);
+        const auto value = parse_number(fields[index + 1]);
+
+        if (!value) {
+          return false;
+        }
+
+        if (!row) {
+          if (m_free_rows.count(fields[index]) == 0) {
+            return false;
+          }
+
+          continue;
+        }
+
+        m_builder.add_entry(*row, m_last_column, *value);
+      }
+
+      return true;
+    }
+
+    bool MpsParser::parse_rhs(const Fields& fields)
+    {
+      for (std::size_t index = 2; index + 1 < fields.size(); index += 2) {
+        if (fields[index].empty()) {
+          break;
+        }
+
+        const auto row = find_row(fields[index]);
+        const auto value = parse_number(fields[index + 1]);
+
+        if (!value) {
+          return false;
+        }
+
+        if (!row) {
+          if (m_free_rows.count(fields[index]) == 0) {
+            return false;
+          }
+
+          continue;
+        }
+
+        if (*row == Objective) {
+          m_builder.objective_constant = -*value;
+        } else {
+          m_rhs[*row] = *value;
+        }
+      }
+
+      return true;
+    }
+
+    bool MpsParser::parse_range(const Fields& fields)
+    {
+      for (std::size_t index = 2; index + 1 < fields.size(); index += 2) {
+        if (fields[index].empty()) {
+          break;
+        }
+
+        const auto row = find_row(fields[index]);
+        const auto value = parse_number(fields[index + 1]);
+
+        if (!row || *row == Objective || !value) {
+          return false;
+        }
+
+        m_ranges[*row] = *value;
+      }
+
+      return true;
+    }
+
+    bool MpsParser::parse_bound(const Fields& fields)
+    {
+      const std::string_view type = fields[0];
+
+      if (fields[2].empty()) {
+        return false;
+      }
+
+      Column& column = m_builder.column_data(m_builder.column(fields[2]));
+      double value = 0.0;
+
+      if (!fields[3].empty()) {
+        const auto number = parse_number(fields[3]);
+
+        if (!number) {
+          return false;
+        }
+
+        value = bound_value(*number);
+      }
+
+      if (iequals(type, "UP") || iequals(type, "UI")) {
+        column.upper = value;
+
+        if (value < 0.0 && column.lower == 0.0) {
+          column.lower = -Infinity;
+        }
+      } else if (iequals(type, "LO") || iequals(type, "LI")) {
+        column.lower = value;
+      } else if (iequals(type, "FX")) {
+        column.lower = column.upper = value;
+      } else if (iequals(type, "FR")) {
+        column.lower = -Infinity;
+        column.upper = Infinity;
+      } else if (iequals(type, "MI")) {
+        column.lower = -Infinity;
+      } else if (iequals(type, "PL")) {
+        column.upper = Infinity;
+      } else if (iequals(type, "BV")) {
+        column.category = VariableCategory::Binary;
+      } else {
+        return false;
+      }
+
+      if (iequals(type, "UI") || iequals(type, "LI")) {
+        column.category = VariableCategory::Integer;
+      }
+
+      return true;
+    }
+
+    // QUADOBJ has one triangle of Q, QMATRIX has all of Q, for 1/2 x'Qx
+    bool MpsParser::parse_quadratic(const Fields& fields)
+    {
+      const auto value = parse_number(fields[3]);
+
+      if (fields[1].empty() || fields[2].empty() || !value) {
+        return false;
+      }
+
+      const std::size_t column0 = m_builder.column(fields[1]);
+      const std::size_t column1 = m_builder.column(fields[2]);
+      const bool triangle = m_section == Section::QuadraticObjective;
+      m_builder.add_quadratic_entry(Objective, column0, column1, (triangle && column0 != column1) ? *value : 0.5 * *value);
+      return true;
+    }
+
+    std::optional<std::size_t> MpsParser::find_row(std::string_view name) const
+    {
+      if (name == m_objective_row) {
+        return Objective;
+      }
+
+      if (auto iterator = m_row_indices.find(name); iterator != m_row_indices.end()) {
+        return iterator->second;
+      }
+
+      return std::nullopt;
+    }
+
+    /*
+     * CPLEX LP
+     */
+
+    enum class TokenType : uint8_t {
+      Name,
+      Number,
+      Operator,
+      Plus,
+      Minus,
+      Colon,
+      Caret,
+      Star,
+      Slash,
+      LeftBracket,
+      RightBracket,
+      Invalid,
+      End,
+    };
+
+    struct Token {
+      TokenType type = TokenType::End;
+      std::string_view text;
+      double value = 0.0;
+      Operator op = Operator::Equal;
+      bool line_start = false;
+    };
+
+    class LpLexer {
+    public:
+      LpLexer(std::string_view content)
+      : m_content(content)
+      {
+      }
+
+      const Token& peek(std::size_t offset = 0)
+      {
+        while (m_tokens.size() <= m_index + offset) {
+          m_tokens.push_back(lex());
+        }
+
+        return m_tokens[m_index + offset];
+      }
+
+      void advance()
+      {
+        peek();
+        ++m_index;
+
+        // only a few tokens of lookahead are kept
+        if (m_index > 16) {
+          m_tokens.erase(m_tokens.begin(), m_tokens.begin() + static_cast<std::ptrdiff_t>(m_index));
+          m_index = 0;
+        }
+      }
+
+    private:
+      static bool is_name_character(char c)
+      {
+        return std::isalnum(static_cast<unsigned char>(c)) || std::string_view("!\"#$%&()/,.;?@_`'{}|~").find(c) != std::string_view::npos;
+      }
+
+      Token lex();
+
+      std::string_view m_content;
+      std::size_t m_position = 0;
+      bool m_line_start = true;
+      std::vector<Token> m_tokens;
+      std::size_t m_index = 0;
+    };
+
+    Token LpLexer::lex()
+    {
+      // spaces and comments
+
+      while (m_position < m_content.size()) {
+        const char c = m_content[m_position];
+
+        if (c == '\n') {
+          m_line_start = true;
+          ++m_position;
+        } else if (is_space(c)) {
+          ++m_position;
+        } else if (c == '\\') {
+          m_position = std::min(m_content.find('\n', m_position), m_content.size());
+        } else {
+          break;
+        }
+      }
+
+      Token token;
+      token.line_start = m_line_start;
+      m_line_start = false;
+
+      if (m_position == m_content.size()) {
+        return token;
+      }
+
+      const std::size_t start = m_position;
+      const char c = m_content[m_position++];
+      const char next = m_position < m_content.size() ? m_content[m_position] : '\0';
+
+      switch (c) {
+        case '<':
+        case '>':
+          token.type = TokenType::Operator;
+          token.op = c == '<' ? Operator::LessEqual : Operator::GreaterEqual;
+          m_position += next == '=' ? 1 : 0;
+          break;
+        case '=':
+          token.type = TokenType::Operator;
+          token.op = next == '<' ? Operator::LessEqual : next == '>' ? Operator::GreaterEqual : Operator::Equal;
+          m_position += (next == '<' || next == '>') ? 1 : 0;
+          break;
+        case '+':
+          token.type = TokenType::Plus;
+          break;
+        case '-':
+          token.type = TokenType::Minus;
+          break;
+        case ':':
+          token.type = TokenType::Colon;
+          break;
+        case '^':
+          token.type = TokenType::Caret;
+          break;
+        case '*':
+          token.type = TokenType::Star;
+          break;
+        case '/':
+          token.type = TokenType::Slash;
+          break;
+        case '[':
+          token.type = TokenType::LeftBracket;
+          break;
+        case ']':
+          token.type = TokenType::RightBracket;
+          break;
+        default:
+          if (std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+            const char* end = m_content.data() + m_content.size();
+            auto [pointer, error] = std::from_chars(m_content.data() + start, end, token.value);
+
+            if (error != std::errc()) {
+              token.type = TokenType::Invalid;
+              break;
+            }
+
+            token.type = TokenType::Number;
+            m_position = static_cast<std::size_t>(pointer - m_content.data());
+          } else if (is_name_character(c)) {
+            while (m_position < m_content.size() && is_name_character(m_content[m_position])) {
+              ++m_position;
+            }
+
+            token.type = TokenType::Name;
+          } else {
+            token.type = TokenType::Invalid;
+          }
+          break;
+      }
+
+      token.text = m_content.substr(start, m_position - start);
+      return token;
+    }
+
+    class LpParser {
+    public:
+      LpParser(std::string_view content)
+      : m_lexer(content)
+      {
+      }
+
+      std::optional<Problem> parse();
+
+    private:
+      enum class Section : uint8_t {
+        None,
+        Minimize,
+        Maximize,
+        Constraints,
+        Bounds,
+        General,
+        Binary,
+        Unsupported,
+        End,
+      };
+
+      struct Term {
+        double coefficient;
+        std::size_t column0;
+        std::size_t column1; // or Linear
+      };
+
+      static constexpr std::size_t Linear = std::size_t(-1);
+
+      Section section_at(std::size_t offset);
+      Section consume_section();
+
+      bool parse_expression(std::vector<Term>& terms, double& constant, bool objective);
+      bool parse_quadratic(std::vector<Term>& terms, bool objective);
+      std::optional<double> parse_value();
+      bool parse_objective();
+      bool parse_constraint();
+      bool parse_bound();
+
+      LpLexer m_lexer;
+      ModelBuilder m_builder;
+      std::vector<Term> m_terms;
+    };
+
+    std::optional<Problem> LpParser::parse()
+    {
+      Section section = consume_section();
+
+      while (section != Section::End) {
+        bool valid = true;
+
+        switch (section) {
+          case Section::Minimize:
+          case Section::Maximize:
+            m_builder.sense = section == Section::Maximize ? Sense::Maximize : Sense::Minimize;
+            valid = parse_objective();
+            break;
+          case Section::Constraints:
+            while (valid && section_at(0) == Section::None) {
+              valid = parse_constraint();
+            }
+            break;
+          case Section::Bounds:
+            while (valid && section_at(0) == Section::None) {
+              valid = parse_bound();
+            }
+            break;
+          case Section::General:
+          case Section::Binary:
+            while (valid && section_at(0) == Section::None) {
+              const Token& token = m_lexer.peek();
+
+              if (token.type != TokenType::Name) {
+                valid = false;
+                break;
+              }
+
+              Column& column = m_builder.column_data(m_builder.column(token.text));
+              column.category = section == Section::Binary ? VariableCategory::Binary : VariableCategory::Integer;
+              m_lexer.advance();
+            }
+            break;
+          default:
+            valid = false;
+            break;
+        }
+
+        if (!valid) {
+          return std::nullopt;
+        }
+
+        section = consume_section();
+      }
+
+      return m_builder.build();
+    }
+
+    // the keywords of the sections are recognized at the start of a line
+    LpParser::Section LpParser::section_at(std::size_t offset)
+    {
+      const Token& token = m_lexer.peek(offset);
+
+      if (token.type == TokenType::End) {
+        return Section::End;
+      }
+
+      if (token.type != TokenType::Name || !token.line_start) {
+        return Section::None;
+      }
+
+      const std::string_view text = token.text;
+
+      if (iequals(text, "minimize") || iequals(text, "minimise") || iequals(text, "minimum") || iequals(text, "min")) {
+        return Section::Minimize;
+      }
+
+      if (iequals(text, "maximize") || iequals(text, "maximise") || iequals(text, "maximum") || iequals(text, "max")) {
+        return Section::Maximize;
+      }
+
+      if (iequals(text, "st") || iequals(text, "st.") || iequals(text, "s.t.")) {
+        return Section::Constraints;
+      }
+
+      if (iequals(text, "subject") || iequals(text, "such") || iequals(text, "lazy") || iequals(text, "user")) {
+        const Token& second = m_lexer.peek(offset + 1);
+
+        if (second.type == TokenType::Name && (iequals(second.text, "to") || iequals(second.text, "that") || iequals(second.text, "constraints") || iequals(second.text, "cuts"))) {
+          return Section::Constraints;
+        }
+
+        return Section::None;
+      }
+
+      if (iequals(text, "bounds") || iequals(text, "bound")) {
+        return Section::Bounds;
+      }
+
+      if (iequals(text, "general") || iequals(text, "generals") || iequals(text, "gen")) {
+        return Section::General;
+      }
+
+      if (iequals(text, "binary") || iequals(text, "binaries") || iequals(text, "bin")) {
+        return Section::Binary;
+      }
+
+      if (iequals(text, "semi") || iequals(text, "semis") || iequals(text, "sos")) {
+        return Section::Unsupported;
+      }
+
+      if (iequals(text, "end")) {
+        return Section::End;
+      }
+
+      return Section::None;
+    }
+
+    LpParser::Section LpParser::consume_section()
+    {
+      const Section section = section_at(0);
+
+      switch (section) {
+        case Section::None:
+          return Section::Unsupported;
+        case Section::End:
+          return Section::End;
+        default:
+          break;
+      }
+
+      const bool two_words = iequals(m_lexer.peek().text, "subject") || iequals(m_lexer.peek().text, "such") || iequals(m_lexer.peek().text, "lazy") || iequals(m_lexer.peek().text, "user");
+      m_lexer.advance();
+
+      if (two_words) {
+        m_lexer.advance();
+      }
+
+      return section;
+    }
+
+    bool LpParser::parse_expression(std::vector<Term>& terms, double& constant, bool objective)
+    {
+      bool first = true;
+
+      for (;;) {
+        const Token& token = m_lexer.peek();
+
+        if (token.type == TokenType::Operator || token.type == TokenType::End || section_at(0) != Section::None) {
+          return !first || objective;
+        }
+
+        double sign = 1.0;
+        bool has_sign = false;
+
+        while (m_lexer.peek().type == TokenType::Plus || m_lexer.peek().type == TokenType::Minus) {
+          sign *= m_lexer.peek().type == TokenType::Minus ? -1.0 : 1.0;
+          has_sign = true;
+          m_lexer.advance();
+        }
+
+        if (!first && !has_sign) {
+          return false;
+        }
+
+        first = false;
+
+        if (m_lexer.peek().type == TokenType::LeftBracket) {
+          m_lexer.advance();
+          const std::size_t start = terms.size();
+
+          if (!parse_quadratic(terms, objective)) {
+            return false;
+          }
+
+          for (std::size_t index = start; index < terms.size(); ++index) {
+            terms[index].coefficient *= sign;
+          }
+
+          continue;
+        }
+
+        double coefficient = 1.0;
+        bool has_coefficient = false;
+
+        if (m_lexer.peek().type == TokenType::Number) {
+          coefficient = m_lexer.peek().value;
+          has_coefficient = true;
+          m_lexer.advance();
+        }
+
+        const Token& name = m_lexer.peek();
+
+        if (name.type == TokenType::Name && (!name.line_start || section_at(0) == Section::None)) {
+          terms.push_back({ sign * coefficient, m_builder.column(name.text), Linear });
+          m_lexer.advance();
+        } else if (has_coefficient) {
+          constant += sign * coefficient;
+        } else {
+          return false;
+        }
+      }
+    }
+
+    // terms in brackets, divided by 2 in the objective
+    bool LpParser::parse_quadratic(std::vector<Term>& terms, bool objective)
+    {
+      bool first = true;
+
+      while (m_lexer.peek().type != TokenType::RightBracket) {
+        double sign = 1.0;
+        bool has_sign = false;
+
+        while (m_lexer.peek().type == TokenType::Plus || m_lexer.peek().type == TokenType::Minus) {
+          sign *= m_lexer.peek().type == TokenType::Minus ? -1.0 : 1.0;
+          has_sign = true;
+          m_lexer.advance();
+        }
+
+        if (!first && !has_sign) {
+          return false;
+        }
+
+        first = false;
+        double coefficient = 1.0;
+
+        if (m_lexer.peek().type == TokenType::Number) {
+          coefficient = m_lexer.peek().value;
+          m_lexer.advance();
+        }
+
+        if (m_lexer.peek().type != TokenType::Name) {
+          return false;
+        }
+
+        const std::size_t column0 = m_builder.column(m_lexer.peek().text);
+        m_lexer.advance();
+
+        if (m_lexer.peek().type == TokenType::Caret) {
+          m_lexer.advance();
+
+          if (m_lexer.peek().type != TokenType::Number || m_lexer.peek().value != 2.0) {
+            return false;
+          }
+
+          m_lexer.advance();
+          terms.push_back({ sign * coefficient, column0, column0 });
+        } else if (m_lexer.peek().type == TokenType::Star) {
+          m_lexer.advance();
+
+          if (m_lexer.peek().type != TokenType::Name) {
+            return false;
+          }
+
+          terms.push_back({ sign * coefficient, column0, m_builder.column(m_lexer.peek().text) });
+          m_lexer.advance();
+        } else {
+          return false;
+        }
+      }
+
+      m_lexer.advance();
+
+      if (!objective) {
+        return true;
+      }
+
+      if (m_lexer.peek().type != TokenType::Slash || m_lexer.peek(1).type != TokenType::Number || m_lexer.peek(1).value != 2.0) {
+        return false;
+      }
+
+      m_lexer.advance();
+      m_lexer.advance();
+
+      for (Term& term : terms) {
+        if (term.column1 != Linear) {
+          term.coefficient *= 0.5;
+        }
+      }
+
+      return true;
+    }
+
+    // a number with its sign, possibly infinite
+    std::optional<double> LpParser::parse_value()
+    {
+      double sign = 1.0;
+
+      if (m_lexer.peek().type == TokenType::Plus || m_lexer.peek().type == TokenType::Minus) {
+        sign = m_lexer.peek().type == TokenType::Minus ? -1.0 : 1.0;
+        m_lexer.advance();
+      }
+
+      const Token& token = m_lexer.peek();
+
+      if (token.type == TokenType::Number) {
+        m_lexer.advance();
+        return sign * token.value;
+      }
+
+      if (token.type == TokenType::Name && (iequals(token.text, "inf") || iequals(token.text, "infinity"))) {
+        m_lexer.advance();
+        return sign * Infinity;
+      }
+
+      return std::nullopt;
+    }
+
+    bool LpParser::parse_objective()
+    {
+      if (m_lexer.peek().type == TokenType::Name && m_lexer.peek(1).type == TokenType::Colon) {
+        m_builder.objective_name = m_lexer.peek().text;
+        m_lexer.advance();
+        m_lexer.advance();
+      }
+
+      m_terms.clear();
+      double constant = 0.0;
+
+      if (!parse_expression(m_terms, constant, true)) {
+        return false;
+      }
+
+      m_builder.objective_constant += constant;
+
+      for (const Term& term : m_terms) {
+        if (term.column1 == Linear) {
+          m_builder.add_entry(Objective, term.column0, term.coefficient);
+        } else {
+          m_builder.add_quadratic_entry(Objective, term.column0, term.column1, term.coefficient);
+        }
+      }
+
+      return true;
+    }
+
+    bool LpParser::parse_constraint()
+    {
+      std::string_view name;
+
+      if (m_lexer.peek().type == TokenType::Name && m_lexer.peek(1).type == TokenType::Colon) {
+        name = m_lexer.peek().text;
+        m_lexer.advance();
+        m_lexer.advance();
+      }
+
+      // ranged constraint: value <= expression <= value
+      std::optional<double> left_value;
+      Operator left_op = Operator::Equal;
+      const std::size_t sign_offset = (m_lexer.peek().type == TokenType::Plus || m_lexer.peek().type == TokenType::Minus) ? 1 : 0;
+      const Token& left = m_lexer.peek(sign_offset);
+
+      if ((left.type == TokenType::Number || (left.type == TokenType::Name && (iequals(left.text, "inf") || iequals(left.text, "infinity")))) && m_lexer.peek(sign_offset + 1).type == TokenType::Operator) {
+        left_value = parse_value();
+        left_op = m_lexer.peek().op;
+        m_lexer.advance();
+      }
+
+      m_terms.clear();
+      double constant = 0.0;
+
+      if (!parse_expression(m_terms, constant, false) || m_lexer.peek().type != TokenType::Operator) {
+        return false;
+      }
+
+      const Operator op = m_lexer.peek().op;
+      m_lexer.advance();
+      const auto right_value = parse_value();
+
+      if (!right_value) {
+        return false;
+      }
+
+      double lower = -Infinity;
+      double upper = Infinity;
+
+      auto apply = [&](Operator op, double value) {
+        switch (op) {
+          case Operator::LessEqual:
+            upper = std::min(upper, value - constant);
+            break;
+          case Operator::GreaterEqual:
+            lower = std::max(lower, value - constant);
+            break;
+          case Operator::Equal:
+            lower = upper = value - constant;
+            break;
+        }
+      };
+
+      apply(op, *right_value);
+
+      if (left_value) {
+        if (left_op != op || op == Operator::Equal) {
+          return false;
+        }
+
+        // a <= e is e >= a
+        apply(op == Operator::LessEqual ? Operator::GreaterEqual : Operator::LessEqual, *left_value);
+      }
+
+      const std::size_t row = m_builder.add_row(name, lower, upper);
+
+      for (const Term& term : m_terms) {
+        if (term.column1 == Linear) {
+          m_builder.add_entry(row, term.column0, term.coefficient);
+        } else {
+          m_builder.add_quadratic_entry(row, term.column0, term.column1, term.coefficient);
+        }
+      }
+
+      return true;
+    }
+
+    bool LpParser::parse_bound()
+    {
+      const Token& token = m_lexer.peek();
+      const bool value_first = token.type != TokenType::Name || iequals(token.text, "inf") || iequals(token.text, "infinity");
+
+      std::optional<double> left_value;
+      Operator left_op = Operator::Equal;
+
+      if (value_first) {
+        left_value = parse_value();
+
+        if (!left_value || m_lexer.peek().type != TokenType::Operator) {
+          return false;
+        }
+
+        left_op = m_lexer.peek().op;
+        m_lexer.advance();
+      }
+
+      if (m_lexer.peek().type != TokenType::Name) {
+        return false;
+      }
+
+      Column& column = m_builder.column_data(m_builder.column(m_lexer.peek().text));
+      m_lexer.advance();
+
+      if (!value_first && m_lexer.peek().type == TokenType::Name && iequals(m_lexer.peek().text, "free")) {
+        m_lexer.advance();
+        column.lower = -Infinity;
+        column.upper = Infinity;
+        return true;
+      }
+
+      if (left_value) {
+        const double value = bound_value(*left_value);
+
+        switch (left_op) {
+          case Operator::LessEqual:
+            column.lower = value;
+            break;
+          case Operator::GreaterEqual:
+            column.upper = value;
+            break;
+          case Operator::Equal:
+            column.lower = column.upper = value;
+            break;
+        }
+      }
+
+      if (m_lexer.peek().type != TokenType::Operator) {
+        return left_value.has_value();
+      }
+
+      const Operator op = m_lexer.peek().op;
+      m_lexer.advance();
+      const auto right_value = parse_value();
+
+      if (!right_value) {
+        return false;
+      }
+
+      const double value = bound_value(*right_value);
+
+      switch (op) {
+        case Operator::LessEqual:
+          column.upper = value;
+          break;
+        case Operator::GreaterEqual:
+          column.lower = value;
+          break;
+        case Operator::Equal:
+          column.lower = column.upper = value;
+          break;
+      }
+
+      return true;
+    }
+
+  }
+
+  std::optional<Problem> read_mps(const std::filesystem::path& path, MpsFormat format)
+  {
+    const details::MappedFile file(path);
+
+    if (!file.is_open()) {
+      return std::nullopt;
+    }
+
+    return parse_mps(file.content(), format);
+  }
+
+  std::optional<Problem> read_lp(const std::filesystem::path& path)
+  {
+    const details::MappedFile file(path);
+
+    if (!file.is_open()) {
+      return std::nullopt;
+    }
+
+    return parse_lp(file.content());
+  }
+
+  std::optional<Problem> parse_mps(std::string_view content, MpsFormat format)
+  {
+    MpsParser parser(content, format);
+    return parser.parse();
+  }
+
+  std::optional<Problem> parse_lp(std::string_view content)
+  {
+    LpParser parser(content);
+    return parser.parse();
+  }
+
+}
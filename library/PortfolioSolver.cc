@@ -0,0 +1,200 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include <lqp/PortfolioSolver.h>
+// clang-format on
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+#include <lqp/GlpkSolver.h>
+
+namespace lqp {
+  namespace {
+    constexpr std::chrono::milliseconds StopPollPeriod(10);
+
+    bool is_definitive(SolutionStatus status)
+    {
+      switch (status) {
+        case SolutionStatus::Optimal:
+        case SolutionStatus::NoFeasibleSolution:
+        case SolutionStatus::UnboundedSolution:
+          return true;
+        default:
+          break;
+      }
+
+      return false;
+    }
+
+    bool is_better(double value, double reference, Sense sense)
+    {
+      switch (sense) {
+        case Sense::Minimize:
+          return value < reference;
+        case Sense::Maximize:
+          return value > reference;
+      }
+
+      assert(false);
+      return false;
+    }
+
+  }
+
+  PortfolioSolver::PortfolioSolver()
+  : m_variants({
+      { false, Branching::DriebeckTomlin, Backtracking::BestLocalBound },
+      { true, Branching::DriebeckTomlin, Backtracking::BestLocalBound },
+      { false, Branching::MostFractional, Backtracking::DepthFirst },
+      { true, Branching::FirstFractional, Backtracking::BestProjection },
+  })
+  {
+  }
+
+  PortfolioSolver::PortfolioSolver(std::vector<PortfolioVariant> variants)
+  : m_variants(std::move(variants))
+  {
+  }
+
+  bool PortfolioSolver::available() const
+  {
+    return true;
+  }
+
+  Solution PortfolioSolver::solve(const Problem& problem, const SolverConfig& config)
+  {
+    std::vector<SolverConfig> configs;
+
+    for (const PortfolioVariant& variant : m_variants) {
+      SolverConfig variant_config = config;
+      variant_config.presolve = variant.presolve;
+      variant_config.branching = variant.branching;
+      variant_config.backtracking = variant.backtracking;
+
+      if (!configs.empty()) {
+        variant_config.verbose = false;
+        variant_config.problem_output.clear();
+        variant_config.solution_output.clear();
+      }
+
+      configs.push_back(std::move(variant_config));
+    }
+
+    if (configs.empty()) {
+      configs.push_back(config);
+    }
+
+    auto has_integer_variables = [&problem]() {
+      auto is_integer = [](const auto& variable) { return variable.category != VariableCategory::Continuous; };
+      const auto* problem_linearization = linearization(problem);
+      return std::any_of(variables(problem).begin(), variables(problem).end(), is_integer)
+          || (problem_linearization != nullptr && std::any_of(problem_linearization->variables.begin(), problem_linearization->variables.end(), is_integer));
+    };
+
+    // the variants differ in the branch and bound, where the stop flag is
+    // polled, so a problem without integer variables is solved only once
+    if (configs.size() == 1 || !GlpkSolver::thread_safe() || !config.use_mip || !has_integer_variables()) {
+      GlpkSolver solver;
+      return solver.solve(problem, configs.front());
+    }
+
+    // the variants share a stop flag, set by the first definitive result
+    // or when the flag of the caller is set
+    std::atomic<bool> stop = false;
+
+    for (SolverConfig& variant_config : configs) {
+      variant_config.stop = &stop;
+    }
+
+    const auto& problem_objective = objective(problem);
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::size_t running = configs.size();
+    std::optional<Solution> definitive;
+    std::optional<Solution> best;
+    double best_value = 0.0;
+    SolutionStatus fallback = SolutionStatus::NotSolved;
+
+    std::vector<std::thread> threads;
+    threads.reserve(configs.size());
+
+    for (const SolverConfig& variant_config : configs) {
+      threads.emplace_back([&, &variant_config = variant_config]() {
+        Solution solution = [&]() {
+          GlpkSolver solver;
+          return solver.solve(problem, variant_config);
+        }();
+
+        GlpkSolver::release_thread_resources();
+
+        const std::lock_guard<std::mutex> lock(mutex);
+        --running;
+        finished.notify_one();
+
+        if (definitive) {
+          return;
+        }
+
+        if (is_definitive(solution.status())) {
+          definitive = std::move(solution);
+          stop = true;
+          return;
+        }
+
+        if (solution.status() == SolutionStatus::Feasible) {
+          const double value = problem_objective.expression.evaluate(solution);
+
+          if (!best || is_better(value, best_value, problem_objective.sense)) {
+            best = std::move(solution);
+            best_value = value;
+          }
+
+          return;
+        }
+
+        if (fallback == SolutionStatus::NotSolved) {
+          fallback = solution.status();
+        }
+      });
+    }
+
+    if (config.stop != nullptr) {
+      std::unique_lock<std::mutex> lock(mutex);
+
+      while (running > 0) {
+        if (config.stop->load(std::memory_order_relaxed)) {
+          stop = true;
+          break;
+        }
+
+        finished.wait_for(lock, StopPollPeriod);
+      }
+    }
+
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+
+    if (definitive) {
+      return std::move(*definitive);
+    }
+
+    if (best) {
+      return std::move(*best);
+    }
+
+    return { fallback };
+  }
+
+}
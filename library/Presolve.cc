@@ -0,0 +1,851 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include <lqp/Presolve.h>
+// clang-format on
+
+#include <cassert>
+#include <cmath>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace lqp {
+
+  namespace {
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+    constexpr double FeasibilityTolerance = 1e-9;
+    constexpr double ParallelTolerance = 1e-12;
+    constexpr std::size_t PassLimit = 32;
+
+    struct Term {
+      uint32_t variable;
+      double coefficient;
+    };
+
+    struct Column {
+      VariableCategory category;
+      double lower;
+      double upper;
+      double cost; // minimized
+      double value = 0.0; // when removed
+      bool quadratic = false;
+      bool removed = false;
+      std::vector<uint32_t> rows; // rebuilt on each pass
+    };
+
+    struct Row {
+      std::vector<Term> terms;
+      double lower;
+      double upper;
+      bool removed = false;
+    };
+
+    VariableRange limits_range(double lower, double upper)
+    {
+      const bool has_lower = std::isfinite(lower);
+      const bool has_upper = std::isfinite(upper);
+
+      if (has_lower && has_upper) {
+        return lower == upper ? fixed(lower) : bounds(lower, upper);
+      }
+
+      if (has_lower) {
+        return lower_bound(lower);
+      }
+
+      if (has_upper) {
+        return upper_bound(upper);
+      }
+
+      return {};
+    }
+
+    std::size_t combine(std::size_t seed, std::size_t value)
+    {
+      return seed ^ (value + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2));
+    }
+
+  }
+
+  class Presolve::Reducer {
+  public:
+    Reducer(Presolve& presolve, const CompiledProblem& problem, bool use_mip);
+
+    bool run();
+    void build(const CompiledProblem& problem);
+
+  private:
+    bool is_integral(const Column& column) const;
+    bool is_binary(const Column& column) const;
+    bool tighten_bounds(uint32_t variable, double lower, double upper);
+
+    bool remove_fixed_columns();
+    bool remove_small_rows();
+    bool remove_duplicate_rows();
+    bool remove_redundant_rows();
+    bool tighten_coefficients(Row& row, double maximum_activity);
+    bool remove_small_columns();
+
+    void record(Reduction::Kind kind, uint32_t variable, double value, const Row* row);
+
+    Presolve& m_presolve;
+    bool m_use_mip = false;
+    bool m_infeasible = false;
+    double m_sign = 1.0;
+    double m_constant = 0.0;
+    std::vector<Column> m_columns;
+    std::vector<Row> m_rows;
+  };
+
+  Presolve::Reducer::Reducer(Presolve& presolve, const CompiledProblem& problem, bool use_mip)
+  : m_presolve(presolve)
+  , m_use_mip(use_mip)
+  , m_sign(problem.sense() == Sense::Maximize ? -1.0 : 1.0)
+  , m_constant(m_sign * problem.objective_constant())
+  {
+    const std::size_t variable_count = problem.variable_count();
+    m_columns.reserve(variable_count);
+
+    for (std::size_t variable = 0; variable < variable_count; ++variable) {
+      Column column;
+      column.category = problem.variable_categories()[variable];
+      column.lower = problem.variable_lower_bounds()[variable];
+      column.upper = problem.variable_upper_bounds()[variable];
+      column.cost = m_sign * problem.objective()[variable];
+      m_columns.push_back(std::move(column));
+    }
+
+    for (const uint32_t variable : problem.quadratic_rows()) {
+      m_columns[variable].quadratic = true;
+    }
+
+    for (const uint32_t variable : problem.quadratic_columns()) {
+      m_columns[variable].quadratic = true;
+    }
+
+    const std::size_t constraint_count = problem.constraint_count();
+    m_rows.reserve(constraint_count);
+
+    for (std::size_t constraint = 0; constraint < constraint_count; ++constraint) {
+      Row row;
+      row.lower = problem.constraint_lower_bounds()[constraint];
+      row.upper = problem.constraint_upper_bounds()[constraint];
+
+      for (std::size_t k = problem.row_starts()[constraint]; k < problem.row_starts()[constraint + 1]; ++k) {
+        if (problem.values()[k] != 0.0) {
+          row.terms.push_back({ problem.column_indices()[k], problem.values()[k] });
+        }
+      }
+
+      std::sort(row.terms.begin(), row.terms.end(), [](const Term& lhs, const Term& rhs) { return lhs.variable < rhs.variable; });
+      m_rows.push_back(std::move(row));
+    }
+  }
+
+  bool Presolve::Reducer::run()
+  {
+    for (uint32_t variable = 0; variable < m_columns.size(); ++variable) {
+      Column& column = m_columns[variable];
+
+      if (column.category == VariableCategory::Binary && m_use_mip) {
+        column.lower = std::max(column.lower, 0.0);
+        column.upper = std::min(column.upper, 1.0);
+      }
+
+      tighten_bounds(variable, column.lower, column.upper);
+    }
+
+    bool changed = true;
+
+    for (std::size_t pass = 0; changed && pass < PassLimit && !m_infeasible; ++pass) {
+      changed = remove_fixed_columns();
+      changed = remove_small_rows() || changed;
+      changed = remove_duplicate_rows() || changed;
+      changed = remove_redundant_rows() || changed;
+      changed = remove_small_columns() || changed;
+    }
+
+    if (!m_infeasible) {
+      remove_fixed_columns();
+    }
+
+    return !m_infeasible;
+  }
+
+  void Presolve::Reducer::build(const CompiledProblem& problem)
+  {
+    Problem& reduced = m_presolve.m_problem;
+    std::vector<std::size_t> indices(m_columns.size(), 0);
+
+    for (uint32_t variable = 0; variable < m_columns.size(); ++variable) {
+      const Column& column = m_columns[variable];
+
+      if (column.removed) {
+        continue;
+      }
+
+      indices[variable] = m_presolve.m_kept_variables.size();
+      m_presolve.m_kept_variables.push_back(variable);
+      reduced.add_variable(column.category, limits_range(column.lower, column.upper), std::string(problem.variable_name(variable)));
+    }
+
+    std::vector<std::size_t> row_starts = { 0 };
+    std::vector<std::size_t> col_indices;
+    std::vector<double> values;
+    std::vector<double> lower;
+    std::vector<double> upper;
+
+    for (const Row& row : m_rows) {
+      if (row.removed) {
+        continue;
+      }
+
+      for (const Term& term : row.terms) {
+        assert(!m_columns[term.variable].removed);
+        col_indices.push_back(indices[term.variable]);
+        values.push_back(term.coefficient);
+      }
+
+      row_starts.push_back(values.size());
+      lower.push_back(row.lower);
+      upper.push_back(row.upper);
+    }
+
+    m_presolve.m_removed_constraint_count = m_rows.size() - lower.size();
+    reduced.add_rows(row_starts, col_indices, values, lower, upper);
+
+    QExpr objective(m_sign * m_constant);
+
+    for (uint32_t variable = 0; variable < m_columns.size(); ++variable) {
+      const Column& column = m_columns[variable];
+
+      if (!column.removed && column.cost != 0.0) {
+        objective.add_term(m_sign * column.cost, VariableId{ indices[variable] });
+      }
+    }
+
+    for (std::size_t k = 0; k < problem.quadratic_values().size(); ++k) {
+      const uint32_t row = problem.quadratic_rows()[k];
+      const uint32_t column = problem.quadratic_columns()[k];
+      objective.add_term(problem.quadratic_values()[k], VariableId{ indices[row] }, VariableId{ indices[column] });
+    }
+
+    reduced.set_objective(problem.sense(), objective, std::string(problem.objective_name()));
+  }
+
+  bool Presolve::Reducer::is_integral(const Column& column) const
+  {
+    return m_use_mip && column.category != VariableCategory::Continuous;
+  }
+
+  bool Presolve::Reducer::is_binary(const Column& column) const
+  {
+    return is_integral(column) && column.lower == 0.0 && column.upper == 1.0;
+  }
+
+  // intersects the bounds of the variable, returns true if they changed
+  bool Presolve::Reducer::tighten_bounds(uint32_t variable, double lower, double upper)
+  {
+    Column& column = m_columns[variable];
+
+    if (is_integral(column)) {
+      lower = std::ceil(lower - FeasibilityTolerance);
+      upper = std::floor(upper + FeasibilityTolerance);
+    }
+
+    bool changed = false;
+
+    if (lower > column.lower + FeasibilityTolerance * std::max(1.0, std::abs(lower))) {
+      column.lower = lower;
+      changed = true;
+    }
+
+    if (upper < column.upper - FeasibilityTolerance * std::max(1.0, std::abs(upper))) {
+      column.upper = upper;
+      changed = true;
+    }
+
+    if (column.lower > column.upper) {
+      if (column.lower > column.upper + FeasibilityTolerance * std::max(1.0, std::abs(column.upper))) {
+        m_infeasible = true;
+      }
+
+      column.upper = column.lower;
+    }
+
+    return changed;
+  }
+
+  // substitutes the fixed variables in the rows and the objective
+  bool Presolve::Reducer::remove_fixed_columns()
+  {
+    bool changed = false;
+
+    for (uint32_t variable = 0; variable < m_columns.size(); ++variable) {
+      Column& column = m_columns[variable];
+
+      if (column.removed || column.quadratic || column.lower != column.upper) {
+        continue;
+      }
+
+      column.value = column.lower;
+      column.removed = true;
+      m_constant += column.cost * column.value;
+      record(Reduction::Fixed, variable, column.value, nullptr);
+      changed = true;
+    }
+
+    if (!changed) {
+      return false;
+    }
+
+    for (Row& row : m_rows) {
+      if (row.removed) {
+        continue;
+      }
+
+      auto iterator = std::remove_if(row.terms.begin(), row.terms.end(), [&](const Term& term) {
+        const Column& column = m_columns[term.variable];
+
+        if (!column.removed) {
+          return false;
+        }
+
+        row.lower -= term.coefficient * column.value;
+        row.upper -= term.coefficient * column.value;
+        return true;
+      });
+
+      row.terms.erase(iterator, row.terms.end());
+    }
+
+    return true;
+  }
+
+  // empty rows are checked, singleton rows become bounds
+  bool Presolve::Reducer::remove_small_rows()
+  {
+    bool changed = false;
+
+    for (Row& row : m_rows) {
+      if (row.removed || row.terms.size() > 1) {
+        continue;
+      }
+
+      if (row.terms.empty()) {
+        if (row.lower > FeasibilityTolerance || row.upper < -FeasibilityTolerance) {
+          m_infeasible = true;
+          return false;
+        }
+      } else {
+        const Term& term = row.terms.front();
+        double lower = row.lower / term.coefficient;
+        double upper = row.upper / term.coefficient;
+
+        if (term.coefficient < 0.0) {
+          std::swap(lower, upper);
+        }
+
+        tighten_bounds(term.variable, lower, upper);
+      }
+
+      row.removed = true;
+      changed = true;
+    }
+
+    return changed;
+  }
+
+  // parallel rows are merged into the first one
+  bool Presolve::Reducer::remove_duplicate_rows()
+  {
+    std::unordered_map<std::size_t, std::vector<uint32_t>> buckets;
+
+    for (uint32_t index = 0; index < m_rows.size(); ++index) {
+      const Row& row = m_rows[index];
+
+      if (row.removed || row.terms.size() < 2) {
+        continue;
+      }
+
+      // the ratios are rounded so that the parallel rows are in the same
+      // bucket, the rows are compared exactly afterwards
+      const double first = row.terms.front().coefficient;
+      std::size_t hash = row.terms.size();
+
+      for (const Term& term : row.terms) {
+        hash = combine(hash, term.variable);
+        hash = combine(hash, std::hash<double>()(std::round(term.coefficient / first * 1e6)));
+      }
+
+      buckets[hash].push_back(index);
+    }
+
+    bool changed = false;
+
+    for (const auto& [hash, indices] : buckets) {
+      for (std::size_t i = 0; i < indices.size(); ++i) {
+        Row& reference = m_rows[indices[i]];
+
+        if (reference.removed) {
+          continue;
+        }
+
+        for (std::size_t j = i + 1; j < indices.size(); ++j) {
+          Row& row = m_rows[indices[j]];
+
+          if (row.removed || row.terms.size() != reference.terms.size()) {
+            continue;
+          }
+
+          const double ratio = row.terms.front().coefficient / reference.terms.front().coefficient;
+          bool parallel = true;
+
+          for (std::size_t k = 0; parallel && k < row.terms.size(); ++k) {
+            const Term& term = row.terms[k];
+            const Term& reference_term = reference.terms[k];
+            parallel = term.variable == reference_term.variable && std::abs(term.coefficient - ratio * reference_term.coefficient) <= ParallelTolerance * std::abs(term.coefficient);
+          }
+
+          if (!parallel) {
+            continue;
+          }
+
+          double lower = row.lower / ratio;
+          double upper = row.upper / ratio;
+
+          if (ratio < 0.0) {
+            std::swap(lower, upper);
+          }
+
+          reference.lower = std::max(reference.lower, lower);
+          reference.upper = std::min(reference.upper, upper);
+
+          if (reference.lower > reference.upper) {
+            if (reference.lower > reference.upper + FeasibilityTolerance * std::max(1.0, std::abs(reference.upper))) {
+              m_infeasible = true;
+              return false;
+            }
+
+            reference.upper = reference.lower;
+          }
+
+          row.removed = true;
+          changed = true;
+        }
+      }
+    }
+
+    return changed;
+  }
+
+  // rows that are always satisfied by the bounds of their variables
+  bool Presolve::Reducer::remove_redundant_rows()
+  {
+    bool changed = false;
+
+    for (Row& row : m_rows) {
+      if (row.removed) {
+        continue;
+      }
+
+      double minimum = 0.0;
+      double maximum = 0.0;
+
+      for (const Term& term : row.terms) {
+        const Column& column = m_columns[term.variable];
+
+        if (term.coefficient > 0.0) {
+          minimum += term.coefficient * column.lower;
+          maximum += term.coefficient * column.upper;
+        } else {
+          minimum += term.coefficient * column.upper;
+          maximum += term.coefficient * column.lower;
+        }
+      }
+
+      const double lower_tolerance = FeasibilityTolerance * std::max(1.0, std::abs(row.lower));
+      const double upper_tolerance = FeasibilityTolerance * std::max(1.0, std::abs(row.upper));
+
+      if (minimum > row.upper + upper_tolerance || maximum < row.lower - lower_tolerance) {
+        m_infeasible = true;
+        return false;
+      }
+
+      if (minimum >= row.lower - lower_tolerance && maximum <= row.upper + upper_tolerance) {
+        row.removed = true;
+        changed = true;
+        continue;
+      }
+
+      if (!m_use_mip) {
+        continue;
+      }
+
+      if (row.lower == -Infinity && std::isfinite(maximum)) {
+        changed = tighten_coefficients(row, maximum) || changed;
+      } else if (row.upper == Infinity && std::isfinite(minimum)) {
+        // same as the opposite row
+        for (Term& term : row.terms) {
+          term.coefficient = -term.coefficient;
+        }
+
+        std::swap(row.lower, row.upper);
+        row.lower = -row.lower;
+        row.upper = -row.upper;
+        changed = tighten_coefficients(row, -minimum) || changed;
+        std::swap(row.lower, row.upper);
+        row.lower = -row.lower;
+        row.upper = -row.upper;
+
+        for (Term& term : row.terms) {
+          term.coefficient = -term.coefficient;
+        }
+      }
+    }
+
+    return changed;
+  }
+
+  // for a row a x + r <= u with x binary, if the row is redundant for one of
+  // the values of x, the coefficient is reduced so that the row is tight for
+  // this value, the integer solutions are the same but the relaxation is
+  // tighter
+  bool Presolve::Reducer::tighten_coefficients(Row& row, double maximum_activity)
+  {
+    bool changed = false;
+
+    for (Term& term : row.terms) {
+      if (!is_binary(m_columns[term.variable])) {
+        continue;
+      }
+
+      const double tolerance = FeasibilityTolerance * std::max(1.0, std::abs(term.coefficient));
+
+      if (term.coefficient > 0.0) {
+        const double rest = maximum_activity - term.coefficient;
+        const double slack = row.upper - rest;
+
+        if (slack > tolerance && slack < term.coefficient - tolerance) {
+          term.coefficient -= slack;
+          row.upper -= slack;
+          maximum_activity -= slack;
+          changed = true;
+        }
+      } else {
+        const double slack = row.upper - (term.coefficient + maximum_activity);
+
+        if (slack > tolerance && slack < -term.coefficient - tolerance) {
+          term.coefficient += slack;
+          changed = true;
+        }
+      }
+    }
+
+    return changed;
+  }
+
+  // empty columns are fixed at their best bound, continuous columns with a
+  // single row are removed when they act as a slack or can be substituted
+  bool Presolve::Reducer::remove_small_columns()
+  {
+    for (Column& column : m_columns) {
+      column.rows.clear();
+    }
+
+    for (uint32_t index = 0; index < m_rows.size(); ++index) {
+      if (m_rows[index].removed) {
+        continue;
+      }
+
+      for (const Term& term : m_rows[index].terms) {
+        m_columns[term.variable].rows.push_back(index);
+      }
+    }
+
+    bool changed = false;
+
+    for (uint32_t variable = 0; variable < m_columns.size(); ++variable) {
+      Column& column = m_columns[variable];
+
+      if (column.removed || column.quadratic || column.rows.size() > 1) {
+        continue;
+      }
+
+      if (column.rows.empty()) {
+        double value = std::clamp(0.0, column.lower, column.upper);
+
+        if (column.cost > 0.0) {
+          value = column.lower;
+        } else if (column.cost < 0.0) {
+          value = column.upper;
+        }
+
+        if (std::isfinite(value)) {
+          column.lower = column.upper = value;
+          changed = true;
+        }
+
+        continue;
+      }
+
+      if (column.category != VariableCategory::Continuous) {
+        continue;
+      }
+
+      Row& row = m_rows[column.rows.front()];
+
+      if (row.removed) {
+        continue;
+      }
+
+      auto iterator = std::find_if(row.terms.begin(), row.terms.end(), [&](const Term& term) { return term.variable == variable; });
+
+      if (iterator == row.terms.end()) {
+        continue;
+      }
+
+      const double coefficient = iterator->coefficient;
+
+      if (column.cost == 0.0) {
+        // l - max(a x) <= r <= u - min(a x)
+        double minimum = coefficient * column.lower;
+        double maximum = coefficient * column.upper;
+
+        if (coefficient < 0.0) {
+          std::swap(minimum, maximum);
+        }
+
+        row.terms.erase(iterator);
+        record(Reduction::Slack, variable, coefficient, &row);
+        row.lower -= maximum;
+        row.upper -= minimum;
+        column.removed = true;
+        changed = true;
+        continue;
+      }
+
+      if (row.lower != row.upper) {
+        continue;
+      }
+
+      // implied bounds of x from a x = b - r
+      double minimum = 0.0;
+      double maximum = 0.0;
+
+      for (const Term& term : row.terms) {
+        if (term.variable == variable) {
+          continue;
+        }
+
+        const Column& other = m_columns[term.variable];
+
+        if (term.coefficient > 0.0) {
+          minimum += term.coefficient * other.lower;
+          maximum += term.coefficient * other.upper;
+        } else {
+          minimum += term.coefficient * other.upper;
+          maximum += term.coefficient * other.lower;
+        }
+      }
+
+      double implied_lower = (row.lower - maximum) / coefficient;
+      double implied_upper = (row.lower - minimum) / coefficient;
+
+      if (coefficient < 0.0) {
+        std::swap(implied_lower, implied_upper);
+      }
+
+      if (implied_lower < column.lower - FeasibilityTolerance * std::max(1.0, std::abs(column.lower)) || implied_upper > column.upper + FeasibilityTolerance * std::max(1.0, std::abs(column.upper))) {
+        continue;
+      }
+
+      // c x = c (b - r) / a
+      row.terms.erase(iterator);
+      record(Reduction::Substitute, variable, coefficient, &row);
+      m_constant += column.cost * row.lower / coefficient;
+
+      for (const Term& term : row.terms) {
+        m_columns[term.variable].cost -= column.cost * term.coefficient / coefficient;
+      }
+
+      row.removed = true;
+      column.removed = true;
+      changed = true;
+    }
+
+    return changed;
+  }
+
+  void Presolve::Reducer::record(Reduction::Kind kind, uint32_t variable, double value, const Row* row)
+  {
+    const Column& column = m_columns[variable];
+    Reduction reduction = { kind, variable, value, 0.0, 0.0, column.lower, column.upper, 0, 0 };
+
+    if (row != nullptr) {
+      reduction.lower = row->lower;
+      reduction.upper = row->upper;
+      reduction.term_start = m_presolve.m_term_variables.size();
+
+      for (const Term& term : row->terms) {
+        m_presolve.m_term_variables.push_back(term.variable);
+        m_presolve.m_term_coefficients.push_back(term.coefficient);
+      }
+
+      reduction.term_end = m_presolve.m_term_variables.size();
+    }
+
+    m_presolve.m_reductions.push_back(reduction);
+  }
+
+  /*
+   * Presolve
+   */
+
+  Presolve::Presolve(const Problem& problem, bool use_mip)
+  {
+    const auto compiled = problem.compile();
+
+    if (!compiled) {
+      m_identity = true;
+      m_problem = problem;
+      return;
+    }
+
+    reduce(*compiled, use_mip);
+  }
+
+  Presolve::Presolve(const CompiledProblem& problem, bool use_mip)
+  {
+    reduce(problem, use_mip);
+  }
+
+  bool Presolve::feasible() const
+  {
+    return m_feasible;
+  }
+
+  const Problem& Presolve::problem() const
+  {
+    return m_problem;
+  }
+
+  std::size_t Presolve::variable_count() const
+  {
+    return m_kept_variables.size();
+  }
+
+  std::size_t Presolve::removed_variable_count() const
+  {
+    return m_variable_count - m_kept_variables.size();
+  }
+
+  std::size_t Presolve::removed_constraint_count() const
+  {
+    return m_removed_constraint_count;
+  }
+
+  Solution Presolve::postsolve(const Solution& solution) const
+  {
+    if (m_identity || (solution.empty() && !m_kept_variables.empty())) {
+      return solution;
+    }
+
+    std::vector<double> values(m_variable_count, 0.0);
+
+    for (std::size_t index = 0; index < m_kept_variables.size(); ++index) {
+      values[m_kept_variables[index]] = solution.value(VariableId{ index });
+    }
+
+    for (auto iterator = m_reductions.rbegin(); iterator != m_reductions.rend(); ++iterator) {
+      const Reduction& reduction = *iterator;
+
+      if (reduction.kind == Reduction::Fixed) {
+        values[reduction.variable] = reduction.value;
+        continue;
+      }
+
+      double rest = 0.0;
+
+      for (std::size_t k = reduction.term_start; k < reduction.term_end; ++k) {
+        rest += m_term_coefficients[k] * values[m_term_variables[k]];
+      }
+
+      const double coefficient = reduction.value;
+
+      if (reduction.kind == Reduction::Substitute) {
+        values[reduction.variable] = (reduction.lower - rest) / coefficient;
+        continue;
+      }
+
+      // the value closest to 0 that satisfies the row
+      double lower = (reduction.lower - rest) / coefficient;
+      double upper = (reduction.upper - rest) / coefficient;
+
+      if (coefficient < 0.0) {
+        std::swap(lower, upper);
+      }
+
+      lower = std::max(lower, reduction.variable_lower);
+      upper = std::min(upper, reduction.variable_upper);
+
+      if (lower > upper) {
+        values[reduction.variable] = (lower + upper) / 2.0;
+      } else {
+        values[reduction.variable] = std::clamp(0.0, lower, upper);
+      }
+    }
+
+    return { solution.status(), std::move(values) };
+  }
+
+  void Presolve::reduce(const CompiledProblem& problem, bool use_mip)
+  {
+    m_variable_count = problem.variable_count();
+
+    Reducer reducer(*this, problem, use_mip);
+
+    if (!reducer.run()) {
+      m_feasible = false;
+      return;
+    }
+
+    reducer.build(problem);
+  }
+
+  /*
+   * PresolveSolver
+   */
+
+  PresolveSolver::PresolveSolver(Solver& solver)
+  : m_solver(&solver)
+  {
+  }
+
+  bool PresolveSolver::available() const
+  {
+    return m_solver->available();
+  }
+
+  Solution PresolveSolver::solve(const Problem& problem, const SolverConfig& config)
+  {
+    const Presolve presolve(problem, config.use_mip);
+
+    if (!presolve.feasible()) {
+      return { SolutionStatus::NoFeasibleSolution };
+    }
+
+    if (presolve.variable_count() == 0) {
+      return presolve.postsolve({ SolutionStatus::Optimal });
+    }
+
+    return presolve.postsolve(m_solver->solve(presolve.problem(), config));
+  }
+
+}
@@ -9,21 +9,100 @@
 #include <cmath>
 
 #include <algorithm>
+#include <functional>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <thread>
 
 #include <lqp/Solution.h>
 
 namespace lqp {
   namespace {
 
-    bool is_binary_binary_product(VariableCategory c0, VariableCategory c1)
+    constexpr std::size_t ExpansionBitLimit = 30;
+    constexpr std::size_t FeasibilityChunkSize = 16384; // variables and constraints checked by a thread
+
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+
+    double lower_limit(const VariableRange& range)
+    {
+      switch (range.type) {
+        case VariableRange::LowerBounded:
+        case VariableRange::Bounded:
+        case VariableRange::Fixed:
+          return range.lower;
+        default:
+          break;
+      }
+
+      return -Infinity;
+    }
+
+    double upper_limit(const VariableRange& range)
     {
-      return c0 == VariableCategory::Binary && c1 == VariableCategory::Binary;
+      switch (range.type) {
+        case VariableRange::UpperBounded:
+        case VariableRange::Bounded:
+        case VariableRange::Fixed:
+          return range.upper;
+        default:
+          break;
+      }
+
+      return +Infinity;
+    }
+
+    // finite bounds of a variable of a product, the bounds of the integer
+    // variables are rounded
+    std::optional<std::pair<double, double>> product_limits(VariableCategory category, const VariableRange& range)
+    {
+      if (category == VariableCategory::Binary) {
+        return std::make_pair(0.0, 1.0);
+      }
+
+      double lower = lower_limit(range);
+      double upper = upper_limit(range);
+
+      if (category == VariableCategory::Integer) {
+        lower = std::ceil(lower);
+        upper = std::floor(upper);
+      }
+
+      if (!std::isfinite(lower) || !std::isfinite(upper)) {
+        return std::nullopt;
+      }
+
+      return std::make_pair(lower, upper);
+    }
+
+    VariableRange limits_range(double lower, double upper)
+    {
+      const bool has_lower = std::isfinite(lower);
+      const bool has_upper = std::isfinite(upper);
+
+      if (has_lower && has_upper) {
+        return lower == upper ? fixed(lower) : bounds(lower, upper);
+      }
+
+      if (has_lower) {
+        return lower_bound(lower);
+      }
+
+      if (has_upper) {
+        return upper_bound(upper);
+      }
+
+      return {};
     }
 
-    bool is_binary_continuous_product(VariableCategory c0, VariableCategory c1)
+    VariableRange default_range(VariableCategory category)
     {
-      return (c0 == VariableCategory::Binary && c1 == VariableCategory::Continuous) || (c1 == VariableCategory::Binary && c0 == VariableCategory::Continuous);
+      if (category == VariableCategory::Binary) {
+        return bounds(0.0, 1.0);
+      }
+
+      return {};
     }
   }
 
@@ -32,15 +111,7 @@ namespace lqp {
     Variable variable;
 
     variable.category = category;
-
-    if (category == VariableCategory::Binary) {
-      variable.range.type = VariableRange::Bounded;
-      variable.range.lower = 0.0;
-      variable.range.upper = 1.0;
-    } else {
-      variable.range.type = VariableRange::Unbounded;
-    }
-
+    variable.range = default_range(category);
     variable.name = std::move(name);
 
     const std::size_t index = m_variables.size();
@@ -63,32 +134,61 @@ namespace lqp {
 
   ConstraintId Problem::add_constraint(Inequality inequality, std::string name)
   {
-    Constraint constraint;
+    const std::size_t index = m_constraints.size();
+    m_constraints.push_back(make_constraint(std::move(inequality), std::move(name)));
+    return ConstraintId{ index };
+  }
 
-    constraint.expression = std::move(inequality.expression);
+  VariableIdRange Problem::add_variables(std::size_t count, VariableCategory category)
+  {
+    return add_variables(count, category, default_range(category));
+  }
 
-    switch (inequality.op) {
-      case Operator::GreaterEqual:
-        constraint.range = lower_bound(0.0);
-        break;
-      case Operator::Equal:
-        constraint.range = fixed(0.0);
-        break;
-      case Operator::LessEqual:
-        constraint.range = upper_bound(0.0);
-        break;
-    }
+  VariableIdRange Problem::add_variables(std::size_t count, VariableCategory category, VariableRange range)
+  {
+    const std::size_t first = m_variables.size();
+    m_variables.resize(first + count, { category, range, "" });
+    return { first, count };
+  }
 
-    constraint.name = std::move(name);
+  ConstraintIdRange Problem::add_rows(const std::vector<std::size_t>& row_starts, const std::vector<std::size_t>& col_indices, const std::vector<double>& values, const std::vector<double>& lower, const std::vector<double>& upper, std::vector<std::string> names)
+  {
+    assert(!row_starts.empty());
+    const std::size_t count = row_starts.size() - 1;
 
-    const std::size_t index = m_constraints.size();
-    m_constraints.push_back(std::move(constraint));
-    return ConstraintId{ index };
+    assert(lower.size() == count && upper.size() == count);
+    assert(names.empty() || names.size() == count);
+    assert(col_indices.size() == values.size() && row_starts.back() <= values.size());
+
+    const std::size_t first = m_constraints.size();
+    m_constraints.reserve(first + count);
+
+    for (std::size_t row = 0; row < count; ++row) {
+      Constraint constraint;
+      constraint.expression.reserve(row_starts[row + 1] - row_starts[row]);
+
+      for (std::size_t k = row_starts[row]; k < row_starts[row + 1]; ++k) {
+        assert(col_indices[k] < m_variables.size());
+        constraint.expression.add_term(values[k], VariableId{ col_indices[k] });
+      }
+
+      constraint.expression.finalize();
+      constraint.range = limits_range(lower[row], upper[row]);
+
+      if (!names.empty()) {
+        constraint.name = std::move(names[row]);
+      }
+
+      m_constraints.push_back(std::move(constraint));
+    }
+
+    return { first, count };
   }
 
-  void Problem::set_objective(Sense sense, const LExpr& expr, std::string name)
+  void Problem::set_objective(Sense sense, const QExpr& expr, std::string name)
   {
     m_objective = { sense, expr, std::move(name) };
+    m_objective.expression.finalize();
   }
 
   std::string Problem::variable_name(VariableId variable) const
@@ -105,6 +205,10 @@ namespace lqp {
 
   bool Problem::is_linear() const
   {
+    if (!m_objective.expression.is_linear()) {
+      return false;
+    }
+
     return std::all_of(m_constraints.begin(), m_constraints.end(), [](const Constraint& constraint) {
       return constraint.expression.is_linear();
     });
@@ -116,139 +220,565 @@ namespace lqp {
       return *this;
     }
 
+    auto maybe_linearization = linearization();
+
+    if (!maybe_linearization) {
+      return std::nullopt;
+    }
+
     Problem result;
     result.m_variables = m_variables;
-    result.m_objective = m_objective;
+    result.m_variables.insert(result.m_variables.end(), maybe_linearization->variables.begin(), maybe_linearization->variables.end());
 
     for (const auto& constraint : m_constraints) {
-      if (!linearize_constraint(constraint, result)) {
-        return std::nullopt;
+      if (constraint.expression.is_linear()) {
+        result.m_constraints.push_back(constraint);
       }
     }
 
+    result.m_constraints.insert(result.m_constraints.end(), maybe_linearization->constraints.begin(), maybe_linearization->constraints.end());
+    result.m_objective = m_objective;
     return result;
   }
 
-  bool Problem::linearize_constraint(const Constraint& constraint, Problem& result) const
+  std::optional<CompiledProblem> Problem::compile() const
   {
-    if (constraint.expression.is_linear()) {
-      result.m_constraints.push_back(constraint);
-      return true;
+    auto maybe_linearization = linearization();
+
+    if (!maybe_linearization) {
+      return std::nullopt;
     }
 
-    QExpr expression = constraint.expression.constant();
-    auto linear_terms = constraint.expression.linear_terms();
+    // the column indices are stored on 32 bits
+    constexpr std::size_t IndexLimit = std::numeric_limits<uint32_t>::max();
+
+    const std::size_t variable_count = m_variables.size() + maybe_linearization->variables.size();
 
-    for (auto& term : linear_terms) {
-      expression += term.coefficient * term.variable;
+    if (variable_count > IndexLimit) {
+      return std::nullopt;
     }
 
-    std::map<std::tuple<VariableId, VariableId>, VariableId> mapping;
-    auto quadratic_terms = constraint.expression.quadratic_terms();
+    CompiledProblem compiled;
 
-    for (auto& term : quadratic_terms) {
-      auto v0 = term.variables[0];
-      auto v1 = term.variables[1];
+    /*
+     * variables
+     */
 
-      auto c0 = m_variables[to_index(v0)].category;
-      auto c1 = m_variables[to_index(v1)].category;
+    compiled.m_variable_categories.reserve(variable_count);
+    compiled.m_variable_lower_bounds.reserve(variable_count);
+    compiled.m_variable_upper_bounds.reserve(variable_count);
 
-      if (is_binary_binary_product(c0, c1)) {
-        auto it = mapping.find(std::make_tuple(v0, v1));
+    auto compile_variable = [&](const Variable& variable) {
+      compiled.m_variable_categories.push_back(variable.category);
+      compiled.m_variable_lower_bounds.push_back(lower_limit(variable.range));
+      compiled.m_variable_upper_bounds.push_back(upper_limit(variable.range));
+      compiled.m_variable_names.add(variable.name);
+    };
 
-        VariableId variable = {};
+    std::for_each(m_variables.begin(), m_variables.end(), compile_variable);
+    std::for_each(maybe_linearization->variables.begin(), maybe_linearization->variables.end(), compile_variable);
 
-        if (it != mapping.end()) {
-          variable = it->second;
-        } else {
-          variable = result.add_variable(VariableCategory::Binary);
-          mapping.insert({ std::make_tuple(v0, v1), variable });
-          result.add_constraint(variable >= v0 + v1 - 1);
-          result.add_constraint(variable <= 0.5 * (v0 + v1));
-        }
+    /*
+     * objective
+     */
 
-        expression += term.coefficient * variable;
-      } else if (is_binary_continuous_product(c0, c1)) {
-        if (c1 == VariableCategory::Binary && c0 == VariableCategory::Continuous) {
-          std::swap(v0, v1);
-        }
+    compiled.m_sense = m_objective.sense;
+    compiled.m_objective_constant = m_objective.expression.constant();
+    compiled.m_objective.resize(variable_count, 0.0);
+    m_objective.expression.scatter_linear_coefficients(compiled.m_objective);
+
+    const auto quadratic_terms = m_objective.expression.quadratic_terms();
+    compiled.m_quadratic_rows.reserve(quadratic_terms.size());
+    compiled.m_quadratic_columns.reserve(quadratic_terms.size());
+    compiled.m_quadratic_values.reserve(quadratic_terms.size());
+
+    for (const auto& term : quadratic_terms) {
+      compiled.m_quadratic_rows.push_back(static_cast<uint32_t>(to_index(term.variables[0])));
+      compiled.m_quadratic_columns.push_back(static_cast<uint32_t>(to_index(term.variables[1])));
+      compiled.m_quadratic_values.push_back(term.coefficient);
+    }
+
+    compiled.m_objective_name = m_objective.name;
+
+    /*
+     * constraints
+     */
+
+    std::size_t constraint_count = maybe_linearization->constraints.size();
+    std::size_t nonzero_count = 0;
+
+    for (const auto& constraint : m_constraints) {
+      if (constraint.expression.is_linear()) {
+        ++constraint_count;
+        nonzero_count += constraint.expression.linear_terms().size();
+      }
+    }
+
+    for (const auto& constraint : maybe_linearization->constraints) {
+      nonzero_count += constraint.expression.linear_terms().size();
+    }
+
+    if (nonzero_count > IndexLimit) {
+      return std::nullopt;
+    }
+
+    compiled.m_constraint_lower_bounds.reserve(constraint_count);
+    compiled.m_constraint_upper_bounds.reserve(constraint_count);
+    compiled.m_row_starts.reserve(constraint_count + 1);
+    compiled.m_column_indices.reserve(nonzero_count);
+    compiled.m_values.reserve(nonzero_count);
+
+    auto compile_constraint = [&](const Constraint& constraint) {
+      const double constant = constraint.expression.constant();
+      compiled.m_constraint_lower_bounds.push_back(lower_limit(constraint.range) - constant);
+      compiled.m_constraint_upper_bounds.push_back(upper_limit(constraint.range) - constant);
+
+      for (const auto& term : constraint.expression.linear_terms()) {
+        compiled.m_column_indices.push_back(static_cast<uint32_t>(to_index(term.variable)));
+        compiled.m_values.push_back(term.coefficient);
+      }
+
+      compiled.m_row_starts.push_back(compiled.m_values.size());
+      compiled.m_constraint_names.add(constraint.name);
+    };
+
+    for (const auto& constraint : m_constraints) {
+      if (constraint.expression.is_linear()) {
+        compile_constraint(constraint);
+      }
+    }
+
+    std::for_each(maybe_linearization->constraints.begin(), maybe_linearization->constraints.end(), compile_constraint);
+
+    return compiled;
+  }
+
+  Problem::Constraint Problem::make_constraint(Inequality inequality, std::string name)
+  {
+    Constraint constraint;
+
+    constraint.expression = std::move(inequality.expression);
+    constraint.expression.finalize();
+
+    switch (inequality.op) {
+      case Operator::GreaterEqual:
+        constraint.range = lower_bound(0.0);
+        break;
+      case Operator::Equal:
+        constraint.range = fixed(0.0);
+        break;
+      case Operator::LessEqual:
+        constraint.range = upper_bound(0.0);
+        break;
+    }
+
+    constraint.name = std::move(name);
+    return constraint;
+  }
+
+  std::size_t Problem::ProductHash::operator()(const std::pair<std::size_t, std::size_t>& product) const
+  {
+    const std::size_t seed = std::hash<std::size_t>()(product.first);
+    return seed ^ (std::hash<std::size_t>()(product.second) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2));
+  }
+
+  VariableId Problem::Linearization::add_variable(VariableCategory category, VariableRange range)
+  {
+    const std::size_t index = variable_count + variables.size();
+    variables.push_back({ category, range, "" });
+    return VariableId{ index };
+  }
+
+  void Problem::Linearization::add_constraint(Inequality inequality)
+  {
+    constraints.push_back(make_constraint(std::move(inequality), ""));
+    origins.push_back(Auxiliary);
+  }
 
-        auto range = m_variables[to_index(v1)].range;
+  // the auxiliary variables are after the variables of the problem, they
+  // are shifted when variables are added to the problem
+  void Problem::Linearization::resize_problem(std::size_t count)
+  {
+    assert(count >= variable_count);
+    const std::size_t offset = count - variable_count;
+
+    auto shift = [&](VariableId variable) {
+      const std::size_t index = to_index(variable);
+      return index < variable_count ? variable : VariableId{ index + offset };
+    };
+
+    if (offset > 0 && !variables.empty()) {
+      for (auto& constraint : constraints) {
+        QExpr expression = constraint.expression.constant();
+        expression.reserve(constraint.expression.linear_terms().size());
 
-        if (range.type != VariableRange::Bounded || range.lower != 0.0) {
-          return false;
+        for (const auto& term : constraint.expression.linear_terms()) {
+          expression.add_term(term.coefficient, shift(term.variable));
         }
 
-        auto it = mapping.find(std::make_tuple(v0, v1));
+        expression.finalize();
+        constraint.expression = std::move(expression);
+      }
+
+      auto shift_index = [&](std::size_t index) {
+        return index < variable_count ? index : index + offset;
+      };
 
-        VariableId variable = {};
+      std::unordered_map<std::pair<std::size_t, std::size_t>, VariableId, ProductHash> shifted_products;
 
-        if (it != mapping.end()) {
-          variable = it->second;
-        } else {
-          variable = result.add_variable(VariableCategory::Continuous, range);
-          mapping.insert({ std::make_tuple(v0, v1), variable });
-          result.add_constraint(variable <= range.upper * v0);
-          result.add_constraint(variable <= v1);
-          result.add_constraint(variable >= v1 - (1.0 - v0) * range.upper);
+      for (const auto& [product, variable] : products) {
+        shifted_products.insert({ std::make_pair(shift_index(product.first), shift_index(product.second)), shift(variable) });
+      }
+
+      products = std::move(shifted_products);
+
+      for (auto& [variable, expansion] : expansions) {
+        for (VariableId& bit : expansion.bits) {
+          bit = shift(bit);
         }
+      }
+    }
+
+    variable_count = count;
+  }
+
+  Problem::LinearizationCache::LinearizationCache(const LinearizationCache& other)
+  {
+    std::lock_guard<std::mutex> lock(other.mutex);
+    constraint_count = other.constraint_count;
+    failed = other.failed;
+    linearization = other.linearization;
+  }
+
+  Problem::LinearizationCache::LinearizationCache(LinearizationCache&& other) noexcept
+  : constraint_count(other.constraint_count)
+  , failed(other.failed)
+  , linearization(std::move(other.linearization))
+  {
+  }
+
+  Problem::LinearizationCache& Problem::LinearizationCache::operator=(const LinearizationCache& other)
+  {
+    if (this != &other) {
+      std::scoped_lock lock(mutex, other.mutex);
+      constraint_count = other.constraint_count;
+      failed = other.failed;
+      linearization = other.linearization;
+    }
+
+    return *this;
+  }
+
+  Problem::LinearizationCache& Problem::LinearizationCache::operator=(LinearizationCache&& other) noexcept
+  {
+    constraint_count = other.constraint_count;
+    failed = other.failed;
+    linearization = std::move(other.linearization);
+    return *this;
+  }
 
-        expression += term.coefficient * variable;
+  const Problem::Linearization* Problem::linearization() const
+  {
+    LinearizationCache& cache = m_linearization_cache;
+    std::lock_guard<std::mutex> lock(cache.mutex);
+
+    if (cache.failed) {
+      return nullptr;
+    }
+
+    cache.linearization.resize_problem(m_variables.size());
+
+    for (; cache.constraint_count < m_constraints.size(); ++cache.constraint_count) {
+      if (m_constraints[cache.constraint_count].expression.is_linear()) {
+        continue;
+      }
+
+      if (!linearize_constraint(cache.constraint_count, cache.linearization)) {
+        cache.failed = true;
+        return nullptr;
+      }
+    }
+
+    return &cache.linearization;
+  }
+
+  bool Problem::linearize_constraint(std::size_t index, Linearization& linearization) const
+  {
+    const Constraint& constraint = m_constraints[index];
+    assert(!constraint.expression.is_linear());
+
+    QExpr expression = constraint.expression.constant();
+    expression.reserve(constraint.expression.linear_terms().size() + constraint.expression.quadratic_terms().size());
+
+    for (const auto& term : constraint.expression.linear_terms()) {
+      expression.add_term(term.coefficient, term.variable);
+    }
+
+    for (const auto& term : constraint.expression.quadratic_terms()) {
+      const VariableId v0 = term.variables[0];
+      const VariableId v1 = term.variables[1];
+
+      const Variable& variable0 = m_variables[to_index(v0)];
+      const Variable& variable1 = m_variables[to_index(v1)];
+
+      if (variable0.range.type == VariableRange::Fixed) {
+        expression.add_term(term.coefficient * variable0.range.lower, v1);
+      } else if (variable1.range.type == VariableRange::Fixed) {
+        expression.add_term(term.coefficient * variable1.range.lower, v0);
+      } else if (v0 == v1 && variable0.category == VariableCategory::Binary) {
+        expression.add_term(term.coefficient, v0); // x^2 = x
+      } else if (auto variable = linearize_product(v0, v1, linearization); variable) {
+        expression.add_term(term.coefficient, *variable);
       } else {
         return false;
       }
     }
 
-    result.m_constraints.push_back({ expression, constraint.range, constraint.name });
+    expression.finalize();
+    linearization.constraints.push_back({ std::move(expression), constraint.range, constraint.name });
+    linearization.origins.push_back(index);
     return true;
   }
 
-  bool Problem::is_feasible(const Solution& solution) const
+  // the variables are from the problem or the linearization
+  std::pair<VariableCategory, VariableRange> Problem::product_variable(VariableId variable, const Linearization& linearization) const
   {
-    // 1. verify that the variables well defined
+    const std::size_t index = to_index(variable);
 
-    std::size_t index = 0;
+    if (index < m_variables.size()) {
+      return { m_variables[index].category, m_variables[index].range };
+    }
 
-    for (const auto& problem_variable : m_variables) {
-      const VariableId variable{ index };
-      const double value = solution.value(variable);
+    const Variable& auxiliary = linearization.variables[index - m_variables.size()];
+    return { auxiliary.category, auxiliary.range };
+  }
 
-      switch (problem_variable.category) {
-        case VariableCategory::Binary:
-          if (value != 0.0 && value != 1.0) {
-            return false;
-          }
+  // returns an auxiliary variable equal to the product of two bounded
+  // variables, if at least one of them is binary or integer
+  std::optional<VariableId> Problem::linearize_product(VariableId v0, VariableId v1, Linearization& linearization) const
+  {
+    if (to_index(v1) < to_index(v0)) {
+      std::swap(v0, v1);
+    }
 
-          break;
+    const auto product = std::make_pair(to_index(v0), to_index(v1));
 
-        case VariableCategory::Integer:
-          if (std::trunc(value) != value) {
-            return false;
-          }
+    if (auto it = linearization.products.find(product); it != linearization.products.end()) {
+      return it->second;
+    }
 
-          if (!problem_variable.range.has_value(value)) {
-            return false;
-          }
+    auto [c0, range0] = product_variable(v0, linearization);
+    auto [c1, range1] = product_variable(v1, linearization);
 
-          break;
+    auto limits0 = product_limits(c0, range0);
+    auto limits1 = product_limits(c1, range1);
 
-        case VariableCategory::Continuous:
-          if (!problem_variable.range.has_value(value)) {
-            return false;
-          }
+    if (!limits0 || !limits1) {
+      return std::nullopt;
+    }
 
-          break;
+    VariableId variable = {};
+
+    if (c0 == VariableCategory::Binary && c1 == VariableCategory::Binary) {
+      // z = b0 b1 is exact with these rows when b0 and b1 are 0 or 1, z
+      // does not need to be integer
+      variable = linearization.add_variable(VariableCategory::Continuous, bounds(0.0, 1.0));
+      linearization.add_constraint(variable >= v0 + v1 - 1);
+      linearization.add_constraint(variable <= v0);
+      linearization.add_constraint(variable <= v1);
+    } else if (c0 == VariableCategory::Binary || c1 == VariableCategory::Binary) {
+      if (c1 == VariableCategory::Binary) {
+        std::swap(v0, v1);
+        std::swap(limits0, limits1);
+      }
+
+      // McCormick envelope of z = b x with b binary and x in [l, u], which
+      // is exact when b is 0 or 1
+      const auto [lower, upper] = *limits1;
+      variable = linearization.add_variable(VariableCategory::Continuous, bounds(std::min(lower, 0.0), std::max(upper, 0.0)));
+
+      if (lower != 0.0) {
+        linearization.add_constraint(variable >= lower * v0);
+      }
+
+      if (upper != 0.0) {
+        linearization.add_constraint(variable <= upper * v0);
+      }
+
+      linearization.add_constraint(variable <= v1 - (1.0 - v0) * lower);
+      linearization.add_constraint(variable >= v1 - (1.0 - v0) * upper);
+    } else if (c0 == VariableCategory::Integer || c1 == VariableCategory::Integer) {
+      // x y = (l + sum 2^k b_k) y = l y + sum 2^k b_k y, with the integer
+      // of the smallest range expanded in binary variables
+      const bool expand0 = c0 == VariableCategory::Integer && (c1 != VariableCategory::Integer || limits0->second - limits0->first <= limits1->second - limits1->first);
+
+      if (!expand0) {
+        std::swap(v0, v1);
+        std::swap(limits0, limits1);
+      }
+
+      const std::vector<VariableId>* bits = binary_expansion(v0, limits0->first, limits0->second, linearization);
+
+      if (bits == nullptr) {
+        return std::nullopt;
+      }
+
+      LExpr expansion(limits0->first, v1);
+      double weight = 1.0;
+
+      for (const VariableId bit : *bits) {
+        auto bit_product = linearize_product(bit, v1, linearization);
+
+        if (!bit_product) {
+          return std::nullopt;
+        }
+
+        expansion.add_term(weight, *bit_product);
+        weight *= 2.0;
       }
 
-      ++index;
+      expansion.finalize();
+
+      const double corners[] = {
+        limits0->first * limits1->first,
+        limits0->first * limits1->second,
+        limits0->second * limits1->first,
+        limits0->second * limits1->second,
+      };
+
+      const auto [lower, upper] = std::minmax_element(std::begin(corners), std::end(corners));
+      variable = linearization.add_variable(VariableCategory::Continuous, *lower == *upper ? fixed(*lower) : bounds(*lower, *upper));
+      linearization.add_constraint(variable == expansion);
+    } else {
+      return std::nullopt;
     }
 
-    // 2. Verify that the constraints are satisfied
+    linearization.products.insert({ product, variable });
+    return variable;
+  }
 
-    return std::all_of(m_constraints.begin(), m_constraints.end(), [&](const Constraint& constraint) {
-      const double value = constraint.expression.evaluate(solution);
-      return constraint.range.has_value(value);
-    });
+  // binary variables b_k with x = l + sum 2^k b_k
+  const std::vector<VariableId>* Problem::binary_expansion(VariableId variable, double lower, double upper, Linearization& linearization) const
+  {
+    const std::size_t index = to_index(variable);
+
+    if (auto it = linearization.expansions.find(index); it != linearization.expansions.end()) {
+      return &it->second.bits;
+    }
+
+    const double range = upper - lower;
+    std::vector<VariableId> bits;
+    LExpr expansion(-1.0, variable);
+    double weight = 1.0;
+
+    while (weight <= range) {
+      if (bits.size() == ExpansionBitLimit) {
+        return nullptr;
+      }
+
+      const VariableId bit = linearization.add_variable(VariableCategory::Binary, bounds(0.0, 1.0));
+      expansion.add_term(weight, bit);
+      bits.push_back(bit);
+      weight *= 2.0;
+    }
+
+    expansion.finalize();
+    linearization.add_constraint(expansion == -lower);
+    return &linearization.expansions.emplace(index, Linearization::Expansion{ lower, std::move(bits) }).first->second.bits;
+  }
+
+  bool Problem::is_feasible(const Solution& solution, double tolerance) const
+  {
+    return check_feasibility(solution, tolerance).feasible();
+  }
+
+  FeasibilityReport Problem::check_feasibility(const Solution& solution, double tolerance, std::size_t thread_count) const
+  {
+    if (thread_count == 0) {
+      thread_count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    const std::size_t variable_count = m_variables.size();
+    const std::size_t constraint_count = m_constraints.size();
+    thread_count = std::clamp((variable_count + constraint_count) / FeasibilityChunkSize, std::size_t(1), thread_count);
+
+    std::vector<FeasibilityReport> reports(thread_count);
+
+    auto check = [&](std::size_t part) {
+      FeasibilityReport& report = reports[part];
+
+      // 1. verify that the variables are well defined
+
+      for (std::size_t index = variable_count * part / thread_count; index < variable_count * (part + 1) / thread_count; ++index) {
+        const Variable& variable = m_variables[index];
+        const double value = solution.value(VariableId{ index });
+        const double violation = variable.range.distance(value);
+
+        report.max_bound_violation = std::max(report.max_bound_violation, violation);
+
+        if (violation > tolerance) {
+          report.violated_variables.push_back(index);
+        }
+
+        if (variable.category == VariableCategory::Continuous) {
+          continue;
+        }
+
+        const double fractionality = std::abs(value - std::round(value));
+        report.max_integrality_violation = std::max(report.max_integrality_violation, fractionality);
+
+        if (fractionality > tolerance) {
+          report.fractional_variables.push_back(index);
+          ++report.integrality_violations[static_cast<std::size_t>(variable.category)];
+        }
+      }
+
+      // 2. verify that the constraints are satisfied
+
+      for (std::size_t index = constraint_count * part / thread_count; index < constraint_count * (part + 1) / thread_count; ++index) {
+        const Constraint& constraint = m_constraints[index];
+        const double violation = constraint.range.distance(constraint.expression.evaluate(solution));
+
+        report.max_constraint_violation = std::max(report.max_constraint_violation, violation);
+
+        if (violation > tolerance) {
+          report.violated_constraints.push_back(index);
+        }
+      }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve(thread_count - 1);
+
+    for (std::size_t part = 1; part < thread_count; ++part) {
+      workers.emplace_back(check, part);
+    }
+
+    check(0);
+
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+
+    // the parts are in order, so are the indices
+
+    FeasibilityReport report = std::move(reports.front());
+
+    for (std::size_t part = 1; part < thread_count; ++part) {
+      const FeasibilityReport& other = reports[part];
+      report.max_bound_violation = std::max(report.max_bound_violation, other.max_bound_violation);
+      report.max_constraint_violation = std::max(report.max_constraint_violation, other.max_constraint_violation);
+      report.max_integrality_violation = std::max(report.max_integrality_violation, other.max_integrality_violation);
+      report.violated_variables.insert(report.violated_variables.end(), other.violated_variables.begin(), other.violated_variables.end());
+      report.violated_constraints.insert(report.violated_constraints.end(), other.violated_constraints.begin(), other.violated_constraints.end());
+      report.fractional_variables.insert(report.fractional_variables.end(), other.fractional_variables.begin(), other.fractional_variables.end());
+
+      for (std::size_t category = 0; category < report.integrality_violations.size(); ++category) {
+        report.integrality_violations[category] += other.integrality_violations[category];
+      }
+    }
+
+    return report;
   }
 
   double Problem::compute_objective_value(const Solution& solution) const
@@ -282,6 +812,9 @@ namespace lqp {
       }
 
       switch (constraint.range.type) {
+        case VariableRange::Unbounded:
+          print_expr_to(constraint.expression, out);
+          break;
         case VariableRange::LowerBounded:
           print_expr_to(constraint.expression, out);
           out << " >= " << constraint.range.lower;
@@ -304,7 +837,7 @@ namespace lqp {
           break;
       }
 
-      std::puts("");
+      out << '\n';
     }
   }
 
@@ -319,9 +852,7 @@ namespace lqp {
       first = false;
     }
 
-    auto linear_terms = expr.linear_terms();
-
-    for (auto& term : linear_terms) {
+    for (const auto& term : expr.linear_terms()) {
       if (first) {
         first = false;
       } else {
@@ -331,9 +862,7 @@ namespace lqp {
       out << term.coefficient << " * " << variable_name(term.variable);
     }
 
-    auto quadratic_terms = expr.quadratic_terms();
-
-    for (auto& term : quadratic_terms) {
+    for (const auto& term : expr.quadratic_terms()) {
       if (first) {
         first = false;
       } else {
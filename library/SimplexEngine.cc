@@ -0,0 +1,873 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include "SimplexEngine.h"
+// clang-format on
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+#include <algorithm>
+#include <limits>
+
+#include <lqp/Problem.h>
+
+namespace lqp::details {
+  namespace {
+    constexpr std::size_t Unset = std::size_t(-1);
+    constexpr double Infinity = std::numeric_limits<double>::infinity();
+    constexpr double PivotTolerance = 1e-9;
+    constexpr double MinimumWeight = 1e-6;
+    constexpr std::size_t RefactorizationPeriod = 64;
+    constexpr std::size_t ProgressPeriod = 100;
+    constexpr std::size_t MaximumRestarts = 8;
+    // below this density of rho, the pivot row is computed row-wise
+    constexpr double SparseRowDensity = 0.1;
+  }
+
+  SimplexEngine::SimplexEngine(const CompiledProblem& problem)
+  : m_variable_count(problem.variable_count())
+  , m_constraint_count(problem.constraint_count())
+  , m_total_count(problem.variable_count() + problem.constraint_count())
+  , m_row_starts(problem.row_starts())
+  , m_row_columns(problem.column_indices())
+  , m_row_values(problem.values())
+  , m_sign(problem.sense() == Sense::Maximize ? -1.0 : 1.0)
+  , m_objective_constant(problem.objective_constant())
+  {
+    // column copy of the matrix
+    m_columns.row_count = m_constraint_count;
+    std::vector<std::size_t> column_sizes(m_variable_count, 0);
+
+    for (const uint32_t column : m_row_columns) {
+      ++column_sizes[column];
+    }
+
+    m_columns.starts.assign(m_variable_count + 1, 0);
+
+    for (std::size_t column = 0; column < m_variable_count; ++column) {
+      m_columns.starts[column + 1] = m_columns.starts[column] + column_sizes[column];
+    }
+
+    m_columns.indices.resize(m_row_columns.size());
+    m_columns.values.resize(m_row_columns.size());
+    std::vector<std::size_t> next(m_columns.starts.begin(), m_columns.starts.end() - 1);
+
+    for (std::size_t row = 0; row < m_constraint_count; ++row) {
+      for (std::size_t p = m_row_starts[row]; p < m_row_starts[row + 1]; ++p) {
+        const std::size_t q = next[m_row_columns[p]]++;
+        m_columns.indices[q] = row;
+        m_columns.values[q] = m_row_values[p];
+      }
+    }
+
+    m_cost.assign(m_total_count, 0.0);
+    std::transform(problem.objective().begin(), problem.objective().end(), m_cost.begin(), [this](double coefficient) {
+      return m_sign * coefficient;
+    });
+
+    m_lower = problem.variable_lower_bounds();
+    m_lower.insert(m_lower.end(), problem.constraint_lower_bounds().begin(), problem.constraint_lower_bounds().end());
+    m_upper = problem.variable_upper_bounds();
+    m_upper.insert(m_upper.end(), problem.constraint_upper_bounds().begin(), problem.constraint_upper_bounds().end());
+
+    m_status.assign(m_total_count, BasisStatus::AtLower);
+    m_head.assign(m_constraint_count, Unset);
+    m_position.assign(m_total_count, Unset);
+    m_primal.assign(m_total_count, 0.0);
+    m_dual.assign(m_total_count, 0.0);
+    m_weights.assign(m_constraint_count, 1.0);
+
+    m_pivot_row.assign(m_total_count, 0.0);
+    m_pivot_marked.assign(m_total_count, false);
+  }
+
+  double SimplexEngine::variable_lower_bound(std::size_t variable) const
+  {
+    assert(variable < m_variable_count);
+    return m_lower[variable];
+  }
+
+  double SimplexEngine::variable_upper_bound(std::size_t variable) const
+  {
+    assert(variable < m_variable_count);
+    return m_upper[variable];
+  }
+
+  void SimplexEngine::set_variable_bounds(std::size_t variable, double lower, double upper)
+  {
+    assert(variable < m_variable_count);
+    m_lower[variable] = lower;
+    m_upper[variable] = upper;
+
+    if (m_status[variable] != BasisStatus::Basic) {
+      set_nonbasic_value(variable);
+    }
+  }
+
+  bool SimplexEngine::set_basis(const std::vector<BasisStatus>& basis)
+  {
+    if (basis.size() != m_total_count) {
+      return false;
+    }
+
+    if (std::size_t(std::count(basis.begin(), basis.end(), BasisStatus::Basic)) != m_constraint_count) {
+      return false;
+    }
+
+    m_status = basis;
+    std::size_t position = 0;
+
+    for (std::size_t index = 0; index < m_total_count; ++index) {
+      if (m_status[index] == BasisStatus::Basic) {
+        m_head[position] = index;
+        m_position[index] = position;
+        ++position;
+      } else {
+        m_position[index] = Unset;
+        set_nonbasic_value(index);
+      }
+    }
+
+    m_weights.assign(m_constraint_count, 1.0);
+    m_has_basis = true;
+    return true;
+  }
+
+  std::vector<BasisStatus> SimplexEngine::basis() const
+  {
+    return m_status;
+  }
+
+  SolutionStatus SimplexEngine::solve(const SimplexOptions& options)
+  {
+    m_options = options;
+    m_iteration_count = 0;
+    m_iteration_limit = options.iteration_limit != 0 ? options.iteration_limit : 50 * m_total_count + 1000;
+
+    for (std::size_t index = 0; index < m_total_count; ++index) {
+      if (m_lower[index] > m_upper[index] + m_options.primal_tolerance) {
+        return SolutionStatus::NoFeasibleSolution;
+      }
+    }
+
+    if (!m_has_basis) {
+      slack_basis();
+    }
+
+    if (!refactorize()) {
+      return SolutionStatus::Error;
+    }
+
+    for (std::size_t restart = 0; restart < MaximumRestarts; ++restart) {
+      compute_duals();
+
+      if (place_nonbasic() > 0) {
+        switch (phase1()) {
+          case LoopResult::Optimal:
+            break;
+          case LoopResult::Limit:
+            return SolutionStatus::Undefined;
+          default:
+            return SolutionStatus::Error;
+        }
+
+        compute_duals();
+
+        if (place_nonbasic() > 0) {
+          return infeasible_or_unbounded();
+        }
+      }
+
+      compute_primal();
+
+      switch (dual_loop()) {
+        case LoopResult::Optimal:
+          // check the solution with a fresh factorization
+          if (!refactorize()) {
+            return SolutionStatus::Error;
+          }
+
+          compute_duals();
+
+          if (const std::size_t dual_infeasibilities = place_nonbasic(); dual_infeasibilities == 0) {
+            compute_primal();
+
+            if (is_primal_feasible()) {
+              if (m_options.verbose) {
+                print_progress();
+              }
+
+              return SolutionStatus::Optimal;
+            }
+          }
+
+          break;
+        case LoopResult::Infeasible:
+          return SolutionStatus::NoFeasibleSolution;
+        case LoopResult::DualInfeasible:
+          break;
+        case LoopResult::Limit:
+          return SolutionStatus::Undefined;
+        case LoopResult::Error:
+          return SolutionStatus::Error;
+      }
+    }
+
+    return SolutionStatus::Error;
+  }
+
+  std::vector<double> SimplexEngine::primal_values() const
+  {
+    return std::vector<double>(m_primal.begin(), m_primal.begin() + static_cast<std::ptrdiff_t>(m_variable_count));
+  }
+
+  double SimplexEngine::objective_value() const
+  {
+    double value = 0.0;
+
+    for (std::size_t index = 0; index < m_variable_count; ++index) {
+      value += m_cost[index] * m_primal[index];
+    }
+
+    return m_sign * value + m_objective_constant;
+  }
+
+  void SimplexEngine::slack_basis()
+  {
+    for (std::size_t index = 0; index < m_variable_count; ++index) {
+      make_nonbasic(index);
+    }
+
+    for (std::size_t row = 0; row < m_constraint_count; ++row) {
+      const std::size_t index = m_variable_count + row;
+      m_status[index] = BasisStatus::Basic;
+      m_head[row] = index;
+      m_position[index] = row;
+    }
+
+    m_weights.assign(m_constraint_count, 1.0);
+    m_has_basis = true;
+  }
+
+  void SimplexEngine::make_nonbasic(std::size_t index)
+  {
+    m_position[index] = Unset;
+
+    if (std::isfinite(m_lower[index])) {
+      m_status[index] = BasisStatus::AtLower;
+    } else if (std::isfinite(m_upper[index])) {
+      m_status[index] = BasisStatus::AtUpper;
+    } else {
+      m_status[index] = BasisStatus::Free;
+    }
+
+    set_nonbasic_value(index);
+  }
+
+  void SimplexEngine::set_nonbasic_value(std::size_t index)
+  {
+    switch (m_status[index]) {
+      case BasisStatus::AtLower:
+        if (std::isfinite(m_lower[index])) {
+          m_primal[index] = m_lower[index];
+        } else {
+          make_nonbasic(index);
+        }
+        break;
+      case BasisStatus::AtUpper:
+        if (std::isfinite(m_upper[index])) {
+          m_primal[index] = m_upper[index];
+        } else {
+          make_nonbasic(index);
+        }
+        break;
+      case BasisStatus::Free:
+        m_primal[index] = 0.0;
+        break;
+      case BasisStatus::Basic:
+        assert(false);
+        break;
+    }
+  }
+
+  // factorizes the basis, the singular columns are replaced by logical
+  // variables
+  bool SimplexEngine::refactorize()
+  {
+    for (std::size_t attempt = 0; attempt <= m_constraint_count; ++attempt) {
+      m_basis_matrix.clear(m_constraint_count);
+
+      for (const std::size_t index : m_head) {
+        for_each_entry(index, [this](std::size_t row, double value) {
+          m_basis_matrix.push(row, value);
+        });
+
+        m_basis_matrix.finish_column();
+      }
+
+      const auto singularities = m_factorization.factorize(m_basis_matrix);
+      m_refactorization_needed = false;
+
+      if (singularities.empty()) {
+        return true;
+      }
+
+      for (const auto& [position, row] : singularities) {
+        const std::size_t leaving = m_head[position];
+        make_nonbasic(leaving);
+
+        const std::size_t entering = m_variable_count + row;
+        assert(m_status[entering] != BasisStatus::Basic);
+        m_status[entering] = BasisStatus::Basic;
+        m_head[position] = entering;
+        m_position[entering] = position;
+        m_weights[position] = 1.0;
+      }
+    }
+
+    return false;
+  }
+
+  void SimplexEngine::compute_primal()
+  {
+    std::vector<double> rhs(m_constraint_count, 0.0);
+
+    for (std::size_t index = 0; index < m_total_count; ++index) {
+      if (m_status[index] == BasisStatus::Basic) {
+        continue;
+      }
+
+      if (const double value = m_primal[index]; value != 0.0) {
+        for_each_entry(index, [&](std::size_t row, double coefficient) {
+          rhs[row] -= coefficient * value;
+        });
+      }
+    }
+
+    m_factorization.ftran(rhs);
+
+    for (std::size_t position = 0; position < m_constraint_count; ++position) {
+      m_primal[m_head[position]] = rhs[position];
+    }
+  }
+
+  void SimplexEngine::compute_duals()
+  {
+    std::vector<double> duals(m_constraint_count);
+
+    for (std::size_t position = 0; position < m_constraint_count; ++position) {
+      duals[position] = m_cost[m_head[position]];
+    }
+
+    m_factorization.btran(duals);
+
+    for (std::size_t index = 0; index < m_total_count; ++index) {
+      if (m_status[index] == BasisStatus::Basic) {
+        m_dual[index] = 0.0;
+        continue;
+      }
+
+      double value = m_cost[index];
+
+      for_each_entry(index, [&](std::size_t row, double coefficient) {
+        value -= coefficient * duals[row];
+      });
+
+      m_dual[index] = value;
+    }
+  }
+
+  // puts the non-basic variables at the bound given by their reduced cost,
+  // returns the number of variables that can not be made dual feasible
+  std::size_t SimplexEngine::place_nonbasic()
+  {
+    const double tolerance = m_options.dual_tolerance;
+    std::size_t infeasibilities = 0;
+
+    for (std::size_t index = 0; index < m_total_count; ++index) {
+      if (m_status[index] == BasisStatus::Basic) {
+        continue;
+      }
+
+      const double dual = m_dual[index];
+      const bool has_lower = std::isfinite(m_lower[index]);
+      const bool has_upper = std::isfinite(m_upper[index]);
+
+      if (has_lower && has_upper) {
+        if (m_lower[index] == m_upper[index]) {
+          m_status[index] = BasisStatus::AtLower;
+        } else if (m_status[index] == BasisStatus::AtLower && dual >= -tolerance) {
+          // already dual feasible
+        } else if (m_status[index] == BasisStatus::AtUpper && dual <= tolerance) {
+          // already dual feasible
+        } else {
+          m_status[index] = dual >= 0.0 ? BasisStatus::AtLower : BasisStatus::AtUpper;
+        }
+      } else if (has_lower) {
+        m_status[index] = BasisStatus::AtLower;
+        infeasibilities += (dual < -tolerance) ? 1 : 0;
+      } else if (has_upper) {
+        m_status[index] = BasisStatus::AtUpper;
+        infeasibilities += (dual > tolerance) ? 1 : 0;
+      } else {
+        m_status[index] = BasisStatus::Free;
+        infeasibilities += (std::abs(dual) > tolerance) ? 1 : 0;
+      }
+
+      set_nonbasic_value(index);
+    }
+
+    return infeasibilities;
+  }
+
+  bool SimplexEngine::is_primal_feasible() const
+  {
+    const double tolerance = m_options.primal_tolerance;
+
+    for (const std::size_t index : m_head) {
+      if (m_primal[index] < m_lower[index] - tolerance || m_primal[index] > m_upper[index] + tolerance) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  SimplexEngine::LoopResult SimplexEngine::dual_loop()
+  {
+    const double primal_tolerance = m_options.primal_tolerance;
+    const double dual_tolerance = m_options.dual_tolerance;
+
+    std::vector<double> rho(m_constraint_count);
+    std::vector<double> column(m_constraint_count);
+    std::vector<double> tau(m_constraint_count);
+    std::vector<double> flips(m_constraint_count);
+    std::vector<Breakpoint> breakpoints;
+
+    for (;;) {
+      if (limit_reached()) {
+        return LoopResult::Limit;
+      }
+
+      if (m_refactorization_needed || m_factorization.update_count() >= RefactorizationPeriod) {
+        if (!refactorize()) {
+          return LoopResult::Error;
+        }
+
+        compute_primal();
+        compute_duals();
+
+        if (place_nonbasic() > 0) {
+          return LoopResult::DualInfeasible;
+        }
+
+        compute_primal();
+      }
+
+      // pricing of the leaving variable with dual steepest edge
+      std::size_t leaving_position = Unset;
+      double best_score = 0.0;
+
+      for (std::size_t position = 0; position < m_constraint_count; ++position) {
+        const std::size_t index = m_head[position];
+        double infeasibility = 0.0;
+
+        if (m_primal[index] < m_lower[index] - primal_tolerance) {
+          infeasibility = m_lower[index] - m_primal[index];
+        } else if (m_primal[index] > m_upper[index] + primal_tolerance) {
+          infeasibility = m_primal[index] - m_upper[index];
+        }
+
+        if (infeasibility > 0.0) {
+          const double score = infeasibility * infeasibility / m_weights[position];
+
+          if (score > best_score) {
+            best_score = score;
+            leaving_position = position;
+          }
+        }
+      }
+
+      if (leaving_position == Unset) {
+        return LoopResult::Optimal;
+      }
+
+      const std::size_t leaving = m_head[leaving_position];
+      const bool to_lower = m_primal[leaving] < m_lower[leaving];
+      const double delta = m_primal[leaving] - (to_lower ? m_lower[leaving] : m_upper[leaving]);
+
+      std::fill(rho.begin(), rho.end(), 0.0);
+      rho[leaving_position] = 1.0;
+      m_factorization.btran(rho);
+
+      compute_pivot_row(rho);
+
+      // bound flipping ratio test: the boxed variables are passed and
+      // flipped as long as the slope of the dual objective stays positive
+      const double direction = to_lower ? -1.0 : 1.0;
+      breakpoints.clear();
+
+      for (const std::size_t index : m_pivot_pattern) {
+        const double alpha = direction * m_pivot_row[index];
+
+        if (m_status[index] == BasisStatus::Basic || std::abs(alpha) < PivotTolerance || m_lower[index] == m_upper[index]) {
+          continue;
+        }
+
+        switch (m_status[index]) {
+          case BasisStatus::AtLower:
+            if (alpha > 0.0) {
+              breakpoints.push_back({ index, std::max(m_dual[index], 0.0) / alpha, alpha });
+            }
+            break;
+          case BasisStatus::AtUpper:
+            if (alpha < 0.0) {
+              breakpoints.push_back({ index, std::min(m_dual[index], 0.0) / alpha, -alpha });
+            }
+            break;
+          case BasisStatus::Free:
+            breakpoints.push_back({ index, std::abs(m_dual[index]) / std::abs(alpha), std::abs(alpha) });
+            break;
+          case BasisStatus::Basic:
+            break;
+        }
+      }
+
+      // the breakpoints are sorted lazily, usually only a few are passed
+      const auto compare_breakpoints = [](const Breakpoint& lhs, const Breakpoint& rhs) {
+        return lhs.ratio > rhs.ratio;
+      };
+
+      std::make_heap(breakpoints.begin(), breakpoints.end(), compare_breakpoints);
+      auto heap_end = breakpoints.end();
+
+      double slope = std::abs(delta);
+
+      while (heap_end != breakpoints.begin()) {
+        const std::size_t index = breakpoints.front().index;
+
+        if (m_status[index] == BasisStatus::Free || !std::isfinite(m_lower[index]) || !std::isfinite(m_upper[index])) {
+          break;
+        }
+
+        const double next_slope = slope - breakpoints.front().magnitude * (m_upper[index] - m_lower[index]);
+
+        if (next_slope <= primal_tolerance) {
+          break;
+        }
+
+        slope = next_slope;
+        // the flipped breakpoints go to the end of the vector
+        std::pop_heap(breakpoints.begin(), heap_end, compare_breakpoints);
+        --heap_end;
+      }
+
+      const std::size_t remaining_count = static_cast<std::size_t>(heap_end - breakpoints.begin());
+      const std::size_t flip_count = breakpoints.size() - remaining_count;
+
+      // Harris pass on the remaining breakpoints, for stability
+      std::size_t entering = Unset;
+
+      if (remaining_count > 0) {
+        double bound = Infinity;
+
+        for (std::size_t k = 0; k < remaining_count; ++k) {
+          bound = std::min(bound, breakpoints[k].ratio + dual_tolerance / breakpoints[k].magnitude);
+        }
+
+        double entering_magnitude = 0.0;
+
+        for (std::size_t k = 0; k < remaining_count; ++k) {
+          if (breakpoints[k].ratio <= bound && breakpoints[k].magnitude > entering_magnitude) {
+            entering_magnitude = breakpoints[k].magnitude;
+            entering = breakpoints[k].index;
+          }
+        }
+      }
+
+      if (entering == Unset) {
+        for (const std::size_t index : m_pivot_pattern) {
+          m_pivot_row[index] = 0.0;
+          m_pivot_marked[index] = false;
+        }
+
+        // confirm with a fresh factorization before concluding
+        if (m_factorization.update_count() > 0) {
+          m_refactorization_needed = true;
+          continue;
+        }
+
+        return LoopResult::Infeasible;
+      }
+
+      std::fill(column.begin(), column.end(), 0.0);
+      for_each_entry(entering, [&](std::size_t row, double value) {
+        column[row] = value;
+      });
+      m_factorization.ftran(column);
+
+      const double row_pivot = m_pivot_row[entering];
+      const double pivot = column[leaving_position];
+
+      // the pivot computed from the row and from the column must agree
+      const bool unstable = std::abs(pivot - row_pivot) > 1e-7 * (1.0 + std::abs(pivot));
+
+      if ((unstable && m_factorization.update_count() > 0) || std::abs(pivot) < PivotTolerance) {
+        for (const std::size_t index : m_pivot_pattern) {
+          m_pivot_row[index] = 0.0;
+          m_pivot_marked[index] = false;
+        }
+
+        if (m_factorization.update_count() > 0) {
+          m_refactorization_needed = true;
+          continue;
+        }
+
+        return LoopResult::Error;
+      }
+
+      // dual steepest edge weights
+      tau = rho;
+      m_factorization.ftran(tau);
+
+      double leaving_weight = 0.0;
+
+      for (const double value : rho) {
+        leaving_weight += value * value;
+      }
+
+      for (std::size_t position = 0; position < m_constraint_count; ++position) {
+        if (position == leaving_position || column[position] == 0.0) {
+          continue;
+        }
+
+        const double ratio = column[position] / pivot;
+        const double weight = m_weights[position] + ratio * (ratio * leaving_weight - 2.0 * tau[position]);
+        m_weights[position] = std::max(weight, MinimumWeight);
+      }
+
+      m_weights[leaving_position] = std::max(leaving_weight / (pivot * pivot), MinimumWeight);
+
+      // dual step
+      double dual_step = m_dual[entering] / row_pivot;
+
+      if ((m_status[entering] == BasisStatus::AtLower && m_dual[entering] < 0.0) || (m_status[entering] == BasisStatus::AtUpper && m_dual[entering] > 0.0)) {
+        dual_step = 0.0;
+      }
+
+      for (const std::size_t index : m_pivot_pattern) {
+        if (m_status[index] != BasisStatus::Basic) {
+          m_dual[index] -= dual_step * m_pivot_row[index];
+        }
+
+        m_pivot_row[index] = 0.0;
+        m_pivot_marked[index] = false;
+      }
+
+      m_dual[entering] = 0.0;
+      m_dual[leaving] = -dual_step;
+
+      // primal step, after the bound flips
+      double primal_delta = delta;
+
+      if (flip_count > 0) {
+        std::fill(flips.begin(), flips.end(), 0.0);
+
+        for (std::size_t k = remaining_count; k < breakpoints.size(); ++k) {
+          const std::size_t index = breakpoints[k].index;
+          double change = 0.0;
+
+          if (m_status[index] == BasisStatus::AtLower) {
+            change = m_upper[index] - m_lower[index];
+            m_status[index] = BasisStatus::AtUpper;
+          } else {
+            change = m_lower[index] - m_upper[index];
+            m_status[index] = BasisStatus::AtLower;
+          }
+
+          m_primal[index] += change;
+
+          for_each_entry(index, [&](std::size_t row, double value) {
+            flips[row] += value * change;
+          });
+        }
+
+        m_factorization.ftran(flips);
+
+        for (std::size_t position = 0; position < m_constraint_count; ++position) {
+          m_primal[m_head[position]] -= flips[position];
+        }
+
+        primal_delta = m_primal[leaving] - (to_lower ? m_lower[leaving] : m_upper[leaving]);
+      }
+
+      const double primal_step = primal_delta / pivot;
+
+      for (std::size_t position = 0; position < m_constraint_count; ++position) {
+        m_primal[m_head[position]] -= primal_step * column[position];
+      }
+
+      m_primal[entering] += primal_step;
+
+      // basis change
+      m_status[leaving] = to_lower ? BasisStatus::AtLower : BasisStatus::AtUpper;
+      m_position[leaving] = Unset;
+      set_nonbasic_value(leaving);
+
+      m_status[entering] = BasisStatus::Basic;
+      m_head[leaving_position] = entering;
+      m_position[entering] = leaving_position;
+
+      m_factorization.update(leaving_position, column);
+      ++m_iteration_count;
+
+      if (m_options.verbose && m_iteration_count % ProgressPeriod == 0) {
+        print_progress();
+      }
+    }
+  }
+
+  // the pivot row is computed row-wise when rho is sparse, and column-wise
+  // otherwise
+  void SimplexEngine::compute_pivot_row(const std::vector<double>& rho)
+  {
+    m_pivot_pattern.clear();
+
+    const std::size_t nonzero_count = std::size_t(std::count_if(rho.begin(), rho.end(), [](double value) {
+      return value != 0.0;
+    }));
+
+    if (static_cast<double>(nonzero_count) < SparseRowDensity * static_cast<double>(m_constraint_count)) {
+      for (std::size_t row = 0; row < m_constraint_count; ++row) {
+        const double value = rho[row];
+
+        if (value == 0.0) {
+          continue;
+        }
+
+        for (std::size_t p = m_row_starts[row]; p < m_row_starts[row + 1]; ++p) {
+          const std::size_t index = m_row_columns[p];
+
+          if (!m_pivot_marked[index]) {
+            m_pivot_marked[index] = true;
+            m_pivot_pattern.push_back(index);
+          }
+
+          m_pivot_row[index] += value * m_row_values[p];
+        }
+
+        const std::size_t logical = m_variable_count + row;
+        m_pivot_marked[logical] = true;
+        m_pivot_pattern.push_back(logical);
+        m_pivot_row[logical] = -value;
+      }
+
+      return;
+    }
+
+    for (std::size_t index = 0; index < m_total_count; ++index) {
+      if (m_status[index] == BasisStatus::Basic) {
+        continue;
+      }
+
+      double value = 0.0;
+
+      for_each_entry(index, [&](std::size_t row, double coefficient) {
+        value += coefficient * rho[row];
+      });
+
+      m_pivot_marked[index] = true;
+      m_pivot_pattern.push_back(index);
+      m_pivot_row[index] = value;
+    }
+  }
+
+  // solves the auxiliary problem where all the bounds are replaced by
+  // small boxes, its optimal basis is dual feasible for the original problem
+  // if the original problem is dual feasible
+  SimplexEngine::LoopResult SimplexEngine::phase1()
+  {
+    const std::vector<double> lower = m_lower;
+    const std::vector<double> upper = m_upper;
+
+    for (std::size_t index = 0; index < m_total_count; ++index) {
+      const bool has_lower = std::isfinite(lower[index]);
+      const bool has_upper = std::isfinite(upper[index]);
+
+      m_lower[index] = has_lower ? 0.0 : -1.0;
+      m_upper[index] = has_upper ? 0.0 : 1.0;
+    }
+
+    place_nonbasic();
+    compute_primal();
+
+    LoopResult result = dual_loop();
+
+    if (result == LoopResult::Infeasible || result == LoopResult::DualInfeasible) {
+      result = LoopResult::Error;
+    }
+
+    m_lower = lower;
+    m_upper = upper;
+    return result;
+  }
+
+  // the problem is dual infeasible, it is unbounded if it is primal feasible
+  SolutionStatus SimplexEngine::infeasible_or_unbounded()
+  {
+    std::vector<double> cost(m_total_count, 0.0);
+    std::swap(cost, m_cost);
+
+    compute_duals();
+    place_nonbasic();
+    compute_primal();
+
+    const LoopResult result = dual_loop();
+    std::swap(cost, m_cost);
+
+    switch (result) {
+      case LoopResult::Optimal:
+        return SolutionStatus::UnboundedSolution;
+      case LoopResult::Infeasible:
+        return SolutionStatus::NoFeasibleSolution;
+      case LoopResult::Limit:
+        return SolutionStatus::Undefined;
+      default:
+        break;
+    }
+
+    return SolutionStatus::Error;
+  }
+
+  bool SimplexEngine::limit_reached() const
+  {
+    if (m_iteration_count >= m_iteration_limit) {
+      return true;
+    }
+
+    if (m_options.stop != nullptr && m_options.stop->load(std::memory_order_relaxed)) {
+      return true;
+    }
+
+    if (m_options.deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= m_options.deadline) {
+      return true;
+    }
+
+    return false;
+  }
+
+  void SimplexEngine::print_progress() const
+  {
+    double infeasibility = 0.0;
+
+    for (const std::size_t index : m_head) {
+      infeasibility += std::max({ m_lower[index] - m_primal[index], m_primal[index] - m_upper[index], 0.0 });
+    }
+
+    std::printf("%8zu: obj = %17.9e inf = %11.3e\n", m_iteration_count, objective_value(), infeasibility);
+  }
+
+}
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_SIMPLEX_ENGINE_H
+#define LQP_SIMPLEX_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include <lqp/CompiledProblem.h>
+#include <lqp/SimplexSolver.h>
+#include <lqp/Solution.h>
+
+#include "BasisFactorization.h"
+
+namespace lqp::details {
+
+  struct SimplexOptions {
+    double primal_tolerance = 1e-7;
+    double dual_tolerance = 1e-7;
+    std::size_t iteration_limit = 0; // 0 for a limit depending on the size
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    const std::atomic<bool>* stop = nullptr;
+    bool verbose = false;
+  };
+
+  // Bounded dual simplex on the computational form A x - r = 0 where r are
+  // the logical variables of the rows, bounded by the bounds of the
+  // constraints. The objective is always minimized internally.
+  class SimplexEngine {
+  public:
+    explicit SimplexEngine(const CompiledProblem& problem);
+
+    std::size_t variable_count() const
+    {
+      return m_variable_count;
+    }
+
+    std::size_t constraint_count() const
+    {
+      return m_constraint_count;
+    }
+
+    double variable_lower_bound(std::size_t variable) const;
+    double variable_upper_bound(std::size_t variable) const;
+    void set_variable_bounds(std::size_t variable, double lower, double upper);
+
+    // the basis has one status per variable followed by one status per
+    // constraint, returns false if the basis does not have the right shape
+    bool set_basis(const std::vector<BasisStatus>& basis);
+    std::vector<BasisStatus> basis() const;
+
+    SolutionStatus solve(const SimplexOptions& options);
+
+    std::vector<double> primal_values() const;
+    double objective_value() const;
+    std::size_t iteration_count() const
+    {
+      return m_iteration_count;
+    }
+
+  private:
+    enum class LoopResult : uint8_t {
+      Optimal,
+      Infeasible,
+      DualInfeasible,
+      Limit,
+      Error,
+    };
+
+    struct Breakpoint {
+      std::size_t index;
+      double ratio;
+      double magnitude;
+    };
+
+    template<typename Func>
+    void for_each_entry(std::size_t index, Func func) const
+    {
+      if (index < m_variable_count) {
+        for (std::size_t p = m_columns.starts[index]; p < m_columns.starts[index + 1]; ++p) {
+          func(m_columns.indices[p], m_columns.values[p]);
+        }
+      } else {
+        func(index - m_variable_count, -1.0);
+      }
+    }
+
+    void slack_basis();
+    void make_nonbasic(std::size_t index);
+    void set_nonbasic_value(std::size_t index);
+
+    bool refactorize();
+    void compute_primal();
+    void compute_duals();
+    std::size_t place_nonbasic();
+    bool is_primal_feasible() const;
+
+    LoopResult dual_loop();
+    LoopResult phase1();
+    SolutionStatus infeasible_or_unbounded();
+    void compute_pivot_row(const std::vector<double>& rho);
+    bool limit_reached() const;
+    void print_progress() const;
+
+    std::size_t m_variable_count = 0;
+    std::size_t m_constraint_count = 0;
+    std::size_t m_total_count = 0;
+
+    SparseColumns m_columns;
+    std::vector<std::size_t> m_row_starts;
+    std::vector<uint32_t> m_row_columns;
+    std::vector<double> m_row_values;
+
+    double m_sign = 1.0;
+    double m_objective_constant = 0.0;
+    std::vector<double> m_cost;
+    std::vector<double> m_lower;
+    std::vector<double> m_upper;
+
+    bool m_has_basis = false;
+    std::vector<BasisStatus> m_status;
+    std::vector<std::size_t> m_head;     // position -> variable
+    std::vector<std::size_t> m_position; // variable -> position
+    std::vector<double> m_primal;
+    std::vector<double> m_dual;
+    std::vector<double> m_weights;       // dual steepest edge
+
+    BasisFactorization m_factorization;
+    SparseColumns m_basis_matrix;
+    bool m_refactorization_needed = false;
+
+    // the pivot row, either for all the variables or for the pattern
+    std::vector<double> m_pivot_row;
+    std::vector<std::size_t> m_pivot_pattern;
+    std::vector<bool> m_pivot_marked;
+
+    SimplexOptions m_options;
+    std::size_t m_iteration_count = 0;
+    std::size_t m_iteration_limit = 0;
+  };
+
+}
+
+#endif // LQP_SIMPLEX_ENGINE_H
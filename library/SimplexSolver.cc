@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include <lqp/SimplexSolver.h>
+// clang-format on
+
+#include <cassert>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+#include "SimplexEngine.h"
+
+namespace lqp {
+
+  bool SimplexSolver::available() const
+  {
+    return true;
+  }
+
+  Solution SimplexSolver::solve(const Problem& problem, const SolverConfig& config)
+  {
+    const auto compiled = problem.compile();
+
+    if (!compiled) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    return solve(*compiled, config);
+  }
+
+  Solution SimplexSolver::solve(const CompiledProblem& problem, const SolverConfig& config)
+  {
+    if (problem.has_quadratic_objective()) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    const auto& categories = problem.variable_categories();
+
+    if (config.use_mip && std::any_of(categories.begin(), categories.end(), [](VariableCategory category) { return category != VariableCategory::Continuous; })) {
+      return { SolutionStatus::NotSolved };
+    }
+
+    details::SimplexEngine engine(problem);
+
+    if (!m_basis.empty()) {
+      engine.set_basis(m_basis);
+    }
+
+    details::SimplexOptions options;
+    options.verbose = config.verbose;
+    options.stop = config.stop;
+
+    if (config.timeout != std::chrono::milliseconds::max()) {
+      options.deadline = std::chrono::steady_clock::now() + config.timeout;
+    }
+
+    const SolutionStatus status = engine.solve(options);
+    m_basis = engine.basis();
+
+    if (status == SolutionStatus::Optimal) {
+      return { status, engine.primal_values() };
+    }
+
+    return { status };
+  }
+
+  const std::vector<BasisStatus>& SimplexSolver::basis() const
+  {
+    return m_basis;
+  }
+
+  void SimplexSolver::set_basis(std::vector<BasisStatus> basis)
+  {
+    m_basis = std::move(basis);
+  }
+
+  void SimplexSolver::clear_basis()
+  {
+    m_basis.clear();
+  }
+
+}
@@ -11,6 +11,12 @@ namespace lqp {
   {
   }
 
+  Solution::Solution(SolutionStatus status, std::vector<double> values)
+  : m_status(status)
+  , m_values(std::move(values))
+  {
+  }
+
   SolutionStatus Solution::status() const
   {
     return m_status;
@@ -28,18 +34,29 @@ namespace lqp {
 
   void Solution::set_value(VariableId variable, double value)
   {
-    m_values[variable] = value;
+    const std::size_t index = to_index(variable);
+
+    if (index >= m_values.size()) {
+      m_values.resize(index + 1, 0.0);
+    }
+
+    m_values[index] = value;
   }
 
   double Solution::value(VariableId variable) const
   {
-    auto it = m_values.find(variable);
+    const std::size_t index = to_index(variable);
 
-    if (it != m_values.end()) {
-      return it->second;
+    if (index < m_values.size()) {
+      return m_values[index];
     }
 
     return 0.0;
   }
 
+  const std::vector<double>& Solution::values() const
+  {
+    return m_values;
+  }
+
 }
@@ -15,21 +15,26 @@ namespace lqp {
 
   Solver::~Solver() = default;
 
-  std::vector<Problem::Variable> Solver::variables(const Problem& problem)
+  const std::vector<Problem::Variable>& Solver::variables(const Problem& problem)
   {
     return problem.m_variables;
   }
 
-  std::vector<Problem::Constraint> Solver::constraints(const Problem& problem)
+  const std::vector<Problem::Constraint>& Solver::constraints(const Problem& problem)
   {
     return problem.m_constraints;
   }
 
-  Problem::Objective Solver::objective(const Problem& problem)
+  const Problem::Objective& Solver::objective(const Problem& problem)
   {
     return problem.m_objective;
   }
 
+  const Problem::Linearization* Solver::linearization(const Problem& problem)
+  {
+    return problem.linearization();
+  }
+
   bool NullSolver::available() const
   {
     return false;
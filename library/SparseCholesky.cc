@@ -0,0 +1,753 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+
+// clang-format off: main header
+#include "SparseCholesky.h"
+// clang-format on
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace lqp::details {
+  namespace {
+    constexpr std::size_t Unset = std::size_t(-1);
+    constexpr double PivotTolerance = 1e-20;
+    constexpr double HugePivot = 1e128;
+
+    enum class NodeState : uint8_t {
+      Variable,
+      Element,
+      Absorbed,
+    };
+
+    void release(std::vector<std::size_t>& list)
+    {
+      std::vector<std::size_t>().swap(list);
+    }
+
+    // pattern of a permuted symmetric matrix, with the original position of
+    // each entry, an entry (i, j) is stored in the column max(i, j) when
+    // upper is true, and in the column min(i, j) otherwise
+    struct Pattern {
+      std::vector<std::size_t> starts;
+      std::vector<std::size_t> indices;
+      std::vector<std::size_t> entries;
+    };
+
+    Pattern permute_pattern(const SparseColumns& lower, const std::vector<std::size_t>& inverse, bool upper)
+    {
+      const std::size_t size = lower.column_count();
+      Pattern pattern;
+      pattern.starts.assign(size + 1, 0);
+
+      auto place = [&](std::size_t row, std::size_t column) {
+        const std::size_t a = inverse[row];
+        const std::size_t b = inverse[column];
+        return upper ? std::make_pair(std::max(a, b), std::min(a, b)) : std::make_pair(std::min(a, b), std::max(a, b));
+      };
+
+      for (std::size_t column = 0; column < size; ++column) {
+        for (std::size_t p = lower.starts[column]; p < lower.starts[column + 1]; ++p) {
+          ++pattern.starts[place(lower.indices[p], column).first + 1];
+        }
+      }
+
+      std::partial_sum(pattern.starts.begin(), pattern.starts.end(), pattern.starts.begin());
+      std::vector<std::size_t> next(pattern.starts.begin(), pattern.starts.end() - 1);
+      pattern.indices.resize(lower.indices.size());
+      pattern.entries.resize(lower.indices.size());
+
+      for (std::size_t column = 0; column < size; ++column) {
+        for (std::size_t p = lower.starts[column]; p < lower.starts[column + 1]; ++p) {
+          const auto [target_column, target_row] = place(lower.indices[p], column);
+          pattern.indices[next[target_column]] = target_row;
+          pattern.entries[next[target_column]] = p;
+          ++next[target_column];
+        }
+      }
+
+      return pattern;
+    }
+
+    std::vector<std::size_t> invert(const std::vector<std::size_t>& permutation)
+    {
+      std::vector<std::size_t> inverse(permutation.size());
+
+      for (std::size_t k = 0; k < permutation.size(); ++k) {
+        inverse[permutation[k]] = k;
+      }
+
+      return inverse;
+    }
+
+    // the upper pattern has the rows i < k of each column k
+    std::vector<std::size_t> elimination_tree(const Pattern& upper)
+    {
+      const std::size_t size = upper.starts.size() - 1;
+      std::vector<std::size_t> parents(size, Unset);
+      std::vector<std::size_t> ancestors(size, Unset);
+
+      for (std::size_t k = 0; k < size; ++k) {
+        for (std::size_t p = upper.starts[k]; p < upper.starts[k + 1]; ++p) {
+          // path compression with the ancestors
+          for (std::size_t i = upper.indices[p]; i != Unset && i < k;) {
+            const std::size_t next = ancestors[i];
+            ancestors[i] = k;
+
+            if (next == Unset) {
+              parents[i] = k;
+            }
+
+            i = next;
+          }
+        }
+      }
+
+      return parents;
+    }
+
+    std::vector<std::size_t> postorder(const std::vector<std::size_t>& parents)
+    {
+      const std::size_t size = parents.size();
+      std::vector<std::size_t> heads(size, Unset);
+      std::vector<std::size_t> next(size, Unset);
+
+      for (std::size_t j = size; j-- > 0;) {
+        if (parents[j] != Unset) {
+          next[j] = heads[parents[j]];
+          heads[parents[j]] = j;
+        }
+      }
+
+      std::vector<std::size_t> order;
+      order.reserve(size);
+      std::vector<std::size_t> stack;
+
+      for (std::size_t root = 0; root < size; ++root) {
+        if (parents[root] != Unset) {
+          continue;
+        }
+
+        stack.push_back(root);
+
+        while (!stack.empty()) {
+          const std::size_t top = stack.back();
+
+          if (const std::size_t child = heads[top]; child != Unset) {
+            heads[top] = next[child];
+            stack.push_back(child);
+          } else {
+            stack.pop_back();
+            order.push_back(top);
+          }
+        }
+      }
+
+      return order;
+    }
+
+    // the nonzeros of row i of L are the nodes of the subtree of the
+    // elimination tree reached from the nonzeros of row i of A
+    std::vector<std::size_t> column_counts(const Pattern& upper, const std::vector<std::size_t>& parents)
+    {
+      const std::size_t size = parents.size();
+      std::vector<std::size_t> counts(size, 1);
+      std::vector<std::size_t> marks(size, Unset);
+
+      for (std::size_t i = 0; i < size; ++i) {
+        marks[i] = i;
+
+        for (std::size_t p = upper.starts[i]; p < upper.starts[i + 1]; ++p) {
+          for (std::size_t j = upper.indices[p]; marks[j] != i; j = parents[j]) {
+            ++counts[j];
+            marks[j] = i;
+          }
+        }
+      }
+
+      return counts;
+    }
+
+  }
+
+  std::vector<std::size_t> minimum_degree_ordering(const SparseColumns& lower)
+  {
+    const std::size_t size = lower.column_count();
+
+    std::vector<std::vector<std::size_t>> adjacency(size);
+
+    for (std::size_t column = 0; column < size; ++column) {
+      for (std::size_t p = lower.starts[column]; p < lower.starts[column + 1]; ++p) {
+        if (const std::size_t row = lower.indices[p]; row != column) {
+          adjacency[row].push_back(column);
+          adjacency[column].push_back(row);
+        }
+      }
+    }
+
+    std::vector<std::size_t> degrees(size);
+
+    for (std::size_t i = 0; i < size; ++i) {
+      std::sort(adjacency[i].begin(), adjacency[i].end());
+      adjacency[i].erase(std::unique(adjacency[i].begin(), adjacency[i].end()), adjacency[i].end());
+      degrees[i] = adjacency[i].size();
+    }
+
+    // quotient graph: the eliminated nodes become elements that hold the
+    // clique of their neighbors
+
+    std::vector<NodeState> states(size, NodeState::Variable);
+    std::vector<std::vector<std::size_t>> elements(size);
+    std::vector<std::vector<std::size_t>> members(size);
+
+    // doubly linked lists of the variables by degree
+    std::vector<std::size_t> heads(size + 1, Unset);
+    std::vector<std::size_t> next(size, Unset);
+    std::vector<std::size_t> previous(size, Unset);
+    std::size_t minimum_degree = 0;
+
+    auto insert = [&](std::size_t i) {
+      const std::size_t degree = degrees[i];
+      next[i] = heads[degree];
+      previous[i] = Unset;
+
+      if (heads[degree] != Unset) {
+        previous[heads[degree]] = i;
+      }
+
+      heads[degree] = i;
+      minimum_degree = std::min(minimum_degree, degree);
+    };
+
+    auto remove = [&](std::size_t i) {
+      if (previous[i] != Unset) {
+        next[previous[i]] = next[i];
+      } else {
+        heads[degrees[i]] = next[i];
+      }
+
+      if (next[i] != Unset) {
+        previous[next[i]] = previous[i];
+      }
+    };
+
+    for (std::size_t i = 0; i < size; ++i) {
+      insert(i);
+    }
+
+    std::vector<std::size_t> order;
+    order.reserve(size);
+
+    std::vector<std::size_t> marks(size, Unset);
+    std::vector<std::size_t> weights(size, 0);
+    std::vector<std::size_t> weight_marks(size, Unset);
+
+    for (std::size_t k = 0; k < size; ++k) {
+      while (heads[minimum_degree] == Unset) {
+        ++minimum_degree;
+      }
+
+      const std::size_t pivot = heads[minimum_degree];
+      remove(pivot);
+      order.push_back(pivot);
+      states[pivot] = NodeState::Element;
+      marks[pivot] = k;
+
+      // the new element absorbs the elements of the pivot
+
+      std::vector<std::size_t> clique;
+
+      for (const std::size_t e : elements[pivot]) {
+        if (states[e] != NodeState::Element) {
+          continue;
+        }
+
+        for (const std::size_t i : members[e]) {
+          if (states[i] == NodeState::Variable && marks[i] != k) {
+            marks[i] = k;
+            clique.push_back(i);
+          }
+        }
+
+        states[e] = NodeState::Absorbed;
+        release(members[e]);
+      }
+
+      for (const std::size_t i : adjacency[pivot]) {
+        if (states[i] == NodeState::Variable && marks[i] != k) {
+          marks[i] = k;
+          clique.push_back(i);
+        }
+      }
+
+      release(adjacency[pivot]);
+      release(elements[pivot]);
+
+      // |Le \ Lp| for the elements adjacent to the clique
+
+      for (const std::size_t i : clique) {
+        remove(i);
+
+        for (const std::size_t e : elements[i]) {
+          if (states[e] != NodeState::Element) {
+            continue;
+          }
+
+          if (weight_marks[e] != k) {
+            weight_marks[e] = k;
+            weights[e] = members[e].size();
+          }
+
+          --weights[e];
+        }
+      }
+
+      // approximate external degrees of the clique
+
+      const std::size_t remaining = size - k - 1;
+
+      for (const std::size_t i : clique) {
+        std::size_t external = 0;
+
+        auto& adjacent_elements = elements[i];
+        adjacent_elements.erase(std::remove_if(adjacent_elements.begin(), adjacent_elements.end(), [&](std::size_t e) {
+          if (states[e] != NodeState::Element) {
+            return true;
+          }
+
+          if (weights[e] == 0) {
+            // aggressive absorption, the element is a subset of the new one
+            states[e] = NodeState::Absorbed;
+            release(members[e]);
+            return true;
+          }
+
+          external += weights[e];
+          return false;
+        }), adjacent_elements.end());
+        adjacent_elements.push_back(pivot);
+
+        auto& adjacent_variables = adjacency[i];
+        adjacent_variables.erase(std::remove_if(adjacent_variables.begin(), adjacent_variables.end(), [&](std::size_t j) {
+          return states[j] != NodeState::Variable || marks[j] == k;
+        }), adjacent_variables.end());
+
+        const std::size_t clique_degree = clique.size() - 1;
+        degrees[i] = std::min({ remaining - 1, degrees[i] + clique_degree, adjacent_variables.size() + clique_degree + external });
+        insert(i);
+      }
+
+      members[pivot] = std::move(clique);
+    }
+
+    return order;
+  }
+
+  void SparseCholesky::analyze(const SparseColumns& lower)
+  {
+    const std::size_t size = lower.column_count();
+    m_size = size;
+
+    // the fill-reducing ordering is followed by a postorder of the
+    // elimination tree, so that the supernodes have consecutive columns and
+    // the children come before their parent
+
+    const std::vector<std::size_t> order = minimum_degree_ordering(lower);
+    std::vector<std::size_t> inverse = invert(order);
+    Pattern upper = permute_pattern(lower, inverse, true);
+    std::vector<std::size_t> parents = elimination_tree(upper);
+    const std::vector<std::size_t> post = postorder(parents);
+
+    m_permutation.resize(size);
+
+    for (std::size_t k = 0; k < size; ++k) {
+      m_permutation[k] = order[post[k]];
+    }
+
+    inverse = invert(m_permutation);
+    upper = permute_pattern(lower, inverse, true);
+    parents = elimination_tree(upper);
+
+    const std::vector<std::size_t> counts = column_counts(upper, parents);
+
+    // fundamental supernodes
+
+    std::vector<std::size_t> column_children(size, 0);
+
+    for (const std::size_t parent : parents) {
+      if (parent != Unset) {
+        ++column_children[parent];
+      }
+    }
+
+    std::vector<std::size_t> column_supernodes(size);
+    m_supernodes.clear();
+
+    for (std::size_t j = 0; j < size; ++j) {
+      if (j > 0 && parents[j - 1] == j && counts[j - 1] == counts[j] + 1 && column_children[j] == 1) {
+        ++m_supernodes.back().column_count;
+      } else {
+        Supernode supernode = {};
+        supernode.first_column = j;
+        supernode.column_count = 1;
+        m_supernodes.push_back(supernode);
+      }
+
+      column_supernodes[j] = m_supernodes.size() - 1;
+    }
+
+    const std::size_t supernode_count = m_supernodes.size();
+    std::vector<std::size_t> child_counts(supernode_count + 1, 0);
+
+    for (Supernode& supernode : m_supernodes) {
+      const std::size_t parent_column = parents[supernode.first_column + supernode.column_count - 1];
+      supernode.parent = parent_column == Unset ? Unset : column_supernodes[parent_column];
+
+      if (supernode.parent != Unset) {
+        ++child_counts[supernode.parent + 1];
+      }
+    }
+
+    std::partial_sum(child_counts.begin(), child_counts.end(), child_counts.begin());
+    m_children.resize(child_counts.back());
+
+    for (std::size_t s = 0; s < supernode_count; ++s) {
+      m_supernodes[s].child_start = m_supernodes[s].child_end = child_counts[s];
+    }
+
+    for (std::size_t s = 0; s < supernode_count; ++s) {
+      if (const std::size_t parent = m_supernodes[s].parent; parent != Unset) {
+        m_children[m_supernodes[parent].child_end++] = s;
+      }
+    }
+
+    // structures of the supernodes, from their entries and the update rows
+    // of their children
+
+    const Pattern by_columns = permute_pattern(lower, inverse, false);
+
+    m_rows.clear();
+    m_relative.clear();
+    m_entries.clear();
+    m_entries.reserve(lower.indices.size());
+
+    std::vector<std::size_t> marks(size, Unset);
+    std::vector<std::size_t> positions(size, Unset);
+    std::size_t factor_size = 0;
+
+    for (std::size_t s = 0; s < supernode_count; ++s) {
+      Supernode& supernode = m_supernodes[s];
+      const std::size_t first = supernode.first_column;
+      const std::size_t last = first + supernode.column_count;
+
+      supernode.row_start = m_rows.size();
+
+      for (std::size_t column = first; column < last; ++column) {
+        m_rows.push_back(column);
+        marks[column] = s;
+      }
+
+      for (std::size_t column = first; column < last; ++column) {
+        for (std::size_t p = by_columns.starts[column]; p < by_columns.starts[column + 1]; ++p) {
+          if (const std::size_t row = by_columns.indices[p]; marks[row] != s) {
+            marks[row] = s;
+            m_rows.push_back(row);
+          }
+        }
+      }
+
+      for (std::size_t c = supernode.child_start; c < supernode.child_end; ++c) {
+        const Supernode& child = m_supernodes[m_children[c]];
+
+        for (std::size_t a = child.column_count; a < child.row_count; ++a) {
+          if (const std::size_t row = m_rows[child.row_start + a]; marks[row] != s) {
+            marks[row] = s;
+            m_rows.push_back(row);
+          }
+        }
+      }
+
+      std::sort(m_rows.begin() + std::ptrdiff_t(supernode.row_start + supernode.column_count), m_rows.end());
+      supernode.row_count = m_rows.size() - supernode.row_start;
+      assert(supernode.row_count == counts[first]);
+
+      for (std::size_t a = 0; a < supernode.row_count; ++a) {
+        positions[m_rows[supernode.row_start + a]] = a;
+      }
+
+      for (std::size_t c = supernode.child_start; c < supernode.child_end; ++c) {
+        Supernode& child = m_supernodes[m_children[c]];
+        child.relative_start = m_relative.size();
+
+        for (std::size_t a = child.column_count; a < child.row_count; ++a) {
+          m_relative.push_back(positions[m_rows[child.row_start + a]]);
+        }
+      }
+
+      supernode.entry_start = m_entries.size();
+
+      for (std::size_t column = first; column < last; ++column) {
+        for (std::size_t p = by_columns.starts[column]; p < by_columns.starts[column + 1]; ++p) {
+          m_entries.push_back({ by_columns.entries[p], (column - first) * supernode.row_count + positions[by_columns.indices[p]] });
+        }
+      }
+
+      supernode.entry_end = m_entries.size();
+      supernode.factor_start = factor_size;
+      factor_size += supernode.row_count * supernode.column_count;
+    }
+
+    m_factor.assign(factor_size, 0.0);
+  }
+
+  std::size_t SparseCholesky::factorize(const std::vector<double>& values, std::size_t thread_count)
+  {
+    const std::size_t supernode_count = m_supernodes.size();
+    m_updates.assign(supernode_count, {});
+    m_replaced_pivots.assign(supernode_count, 0);
+
+    double maximum = 0.0;
+
+    for (const double value : values) {
+      maximum = std::max(maximum, std::abs(value));
+    }
+
+    const double pivot_threshold = PivotTolerance * maximum;
+
+    if (thread_count <= 1 || supernode_count < 2) {
+      for (std::size_t s = 0; s < supernode_count; ++s) {
+        factorize_supernode(s, values, pivot_threshold);
+      }
+    } else {
+      // a supernode is ready when all its children are factorized
+      std::mutex mutex;
+      std::condition_variable condition;
+      std::vector<std::size_t> ready;
+      std::vector<std::size_t> pending(supernode_count);
+      std::size_t done = 0;
+
+      for (std::size_t s = supernode_count; s-- > 0;) {
+        pending[s] = m_supernodes[s].child_end - m_supernodes[s].child_start;
+
+        if (pending[s] == 0) {
+          ready.push_back(s);
+        }
+      }
+
+      auto worker = [&]() {
+        for (;;) {
+          std::size_t s = Unset;
+
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [&]() { return !ready.empty() || done == supernode_count; });
+
+            if (ready.empty()) {
+              return;
+            }
+
+            s = ready.back();
+            ready.pop_back();
+          }
+
+          factorize_supernode(s, values, pivot_threshold);
+
+          std::lock_guard<std::mutex> lock(mutex);
+          ++done;
+
+          if (const std::size_t parent = m_supernodes[s].parent; parent != Unset && --pending[parent] == 0) {
+            ready.push_back(parent);
+            condition.notify_one();
+          }
+
+          if (done == supernode_count) {
+            condition.notify_all();
+          }
+        }
+      };
+
+      std::vector<std::thread> workers;
+      workers.reserve(thread_count);
+
+      for (std::size_t i = 0; i < thread_count; ++i) {
+        workers.emplace_back(worker);
+      }
+
+      for (std::thread& thread : workers) {
+        thread.join();
+      }
+    }
+
+    return std::accumulate(m_replaced_pivots.begin(), m_replaced_pivots.end(), std::size_t(0));
+  }
+
+  void SparseCholesky::factorize_supernode(std::size_t index, const std::vector<double>& values, double pivot_threshold)
+  {
+    const Supernode& supernode = m_supernodes[index];
+    const std::size_t m = supernode.row_count;
+    const std::size_t k = supernode.column_count;
+    const std::size_t u = m - k;
+
+    // assembly of the front, only the lower triangle is used
+
+    std::vector<double> front(m * m, 0.0);
+
+    for (std::size_t e = supernode.entry_start; e < supernode.entry_end; ++e) {
+      front[m_entries[e].offset] += values[m_entries[e].index];
+    }
+
+    for (std::size_t c = supernode.child_start; c < supernode.child_end; ++c) {
+      const std::size_t child_index = m_children[c];
+      const Supernode& child = m_supernodes[child_index];
+      const std::size_t child_size = child.row_count - child.column_count;
+      const std::size_t* relative = m_relative.data() + child.relative_start;
+      const std::vector<double>& update = m_updates[child_index];
+
+      for (std::size_t b = 0; b < child_size; ++b) {
+        double* target = front.data() + relative[b] * m;
+        const double* source = update.data() + b * child_size;
+
+        for (std::size_t a = b; a < child_size; ++a) {
+          target[relative[a]] += source[a];
+        }
+      }
+
+      std::vector<double>().swap(m_updates[child_index]);
+    }
+
+    // dense factorization of the pivot columns
+
+    for (std::size_t j = 0; j < k; ++j) {
+      double* column = front.data() + j * m;
+      double pivot = column[j];
+
+      if (!(pivot > pivot_threshold)) {
+        pivot = HugePivot;
+        ++m_replaced_pivots[index];
+      }
+
+      const double diagonal = std::sqrt(pivot);
+      column[j] = diagonal;
+
+      for (std::size_t i = j + 1; i < m; ++i) {
+        column[i] /= diagonal;
+      }
+
+      for (std::size_t c = j + 1; c < k; ++c) {
+        if (const double factor = column[c]; factor != 0.0) {
+          double* target = front.data() + c * m;
+
+          for (std::size_t i = c; i < m; ++i) {
+            target[i] -= column[i] * factor;
+          }
+        }
+      }
+    }
+
+    double* factor = m_factor.data() + supernode.factor_start;
+
+    for (std::size_t j = 0; j < k; ++j) {
+      std::copy_n(front.data() + j * m, m, factor + j * m);
+    }
+
+    if (u == 0) {
+      return;
+    }
+
+    // update matrix F22 - L21 L21^T for the parent
+
+    std::vector<double> update(u * u, 0.0);
+
+    for (std::size_t b = 0; b < u; ++b) {
+      double* target = update.data() + b * u;
+      const double* source = front.data() + (k + b) * m + k;
+
+      for (std::size_t a = b; a < u; ++a) {
+        target[a] = source[a];
+      }
+
+      for (std::size_t p = 0; p < k; ++p) {
+        const double* column = factor + p * m + k;
+
+        if (const double f = column[b]; f != 0.0) {
+          for (std::size_t a = b; a < u; ++a) {
+            target[a] -= column[a] * f;
+          }
+        }
+      }
+    }
+
+    m_updates[index] = std::move(update);
+  }
+
+  void SparseCholesky::solve(std::vector<double>& values) const
+  {
+    std::vector<double> x(m_size);
+
+    for (std::size_t k = 0; k < m_size; ++k) {
+      x[k] = values[m_permutation[k]];
+    }
+
+    // L y = b
+
+    for (const Supernode& supernode : m_supernodes) {
+      const double* factor = m_factor.data() + supernode.factor_start;
+      const std::size_t* rows = m_rows.data() + supernode.row_start;
+
+      for (std::size_t j = 0; j < supernode.column_count; ++j) {
+        const double* column = factor + j * supernode.row_count;
+        const double value = x[supernode.first_column + j] / column[j];
+        x[supernode.first_column + j] = value;
+
+        if (value != 0.0) {
+          for (std::size_t i = j + 1; i < supernode.row_count; ++i) {
+            x[rows[i]] -= column[i] * value;
+          }
+        }
+      }
+    }
+
+    // L^T x = y
+
+    for (auto it = m_supernodes.rbegin(); it != m_supernodes.rend(); ++it) {
+      const Supernode& supernode = *it;
+      const double* factor = m_factor.data() + supernode.factor_start;
+      const std::size_t* rows = m_rows.data() + supernode.row_start;
+
+      for (std::size_t j = supernode.column_count; j-- > 0;) {
+        const double* column = factor + j * supernode.row_count;
+        double value = x[supernode.first_column + j];
+
+        for (std::size_t i = j + 1; i < supernode.row_count; ++i) {
+          value -= column[i] * x[rows[i]];
+        }
+
+        x[supernode.first_column + j] = value / column[j];
+      }
+    }
+
+    for (std::size_t k = 0; k < m_size; ++k) {
+      values[m_permutation[k]] = x[k];
+    }
+  }
+
+  std::size_t SparseCholesky::factor_nonzero_count() const
+  {
+    std::size_t count = 0;
+
+    for (const Supernode& supernode : m_supernodes) {
+      const std::size_t k = supernode.column_count;
+      count += k * (k + 1) / 2 + (supernode.row_count - k) * k;
+    }
+
+    return count;
+  }
+
+}
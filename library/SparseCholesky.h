@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_SPARSE_CHOLESKY_H
+#define LQP_SPARSE_CHOLESKY_H
+
+#include <cstddef>
+
+#include <vector>
+
+#include "BasisFactorization.h"
+
+namespace lqp::details {
+
+  // fill-reducing ordering of a symmetric matrix given by the pattern of its
+  // lower triangle, with an approximate minimum degree on the quotient
+  // graph, returns the permutation new -> old
+  std::vector<std::size_t> minimum_degree_ordering(const SparseColumns& lower);
+
+  // Supernodal multifrontal Cholesky factorization P A P^T = L L^T of a
+  // symmetric positive definite matrix. The symbolic analysis is done once
+  // for a pattern and the numeric factorization can be repeated with new
+  // values. The independent subtrees of the assembly tree are factorized
+  // concurrently.
+  class SparseCholesky {
+  public:
+    // the pattern is the lower triangle of the matrix, with the diagonal
+    void analyze(const SparseColumns& lower);
+
+    // the values are in the order of the analyzed pattern, the pivots that
+    // are too small are replaced with a huge value, which removes the
+    // corresponding direction from the solution, returns their count
+    std::size_t factorize(const std::vector<double>& values, std::size_t thread_count);
+
+    // solves A x = b in place
+    void solve(std::vector<double>& values) const;
+
+    std::size_t factor_nonzero_count() const;
+
+  private:
+    struct Supernode {
+      std::size_t first_column;
+      std::size_t column_count;
+      std::size_t parent;
+      std::size_t row_start;      // rows in m_rows, the columns first
+      std::size_t row_count;
+      std::size_t factor_start;   // column-major block of row_count x column_count in m_factor
+      std::size_t relative_start; // position in the parent front of each update row, in m_relative
+      std::size_t child_start;    // children in m_children
+      std::size_t child_end;
+      std::size_t entry_start;    // entries of the matrix in m_entries
+      std::size_t entry_end;
+    };
+
+    struct Entry {
+      std::size_t index;  // in the values of the matrix
+      std::size_t offset; // in the front
+    };
+
+    void factorize_supernode(std::size_t index, const std::vector<double>& values, double pivot_threshold);
+
+    std::size_t m_size = 0;
+    std::vector<std::size_t> m_permutation; // new -> old
+
+    std::vector<Supernode> m_supernodes;
+    std::vector<std::size_t> m_children;
+    std::vector<std::size_t> m_rows;
+    std::vector<std::size_t> m_relative;
+    std::vector<Entry> m_entries;
+
+    std::vector<double> m_factor;
+    std::vector<std::vector<double>> m_updates; // update matrix of each supernode for its parent
+    std::vector<std::size_t> m_replaced_pivots; // per supernode
+  };
+
+}
+
+#endif // LQP_SPARSE_CHOLESKY_H
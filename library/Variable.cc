@@ -7,6 +7,7 @@
 
 #include <cassert>
 
+#include <algorithm>
 
 namespace lqp {
 
@@ -29,6 +30,24 @@ namespace lqp {
     return true;
   }
 
+  double VariableRange::distance(double value) const
+  {
+    switch (type) {
+      case Unbounded:
+        return 0.0;
+      case LowerBounded:
+        return std::max(lower - value, 0.0);
+      case UpperBounded:
+        return std::max(value - upper, 0.0);
+      case Bounded:
+      case Fixed:
+        return std::max({ lower - value, value - upper, 0.0 });
+    }
+
+    assert(false);
+    return 0.0;
+  }
+
   VariableRange upper_bound(double value)
   {
     return { VariableRange::UpperBounded, value, value };
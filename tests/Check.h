@@ -0,0 +1,30 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#ifndef LQP_TESTS_CHECK_H
+#define LQP_TESTS_CHECK_H
+
+#include <cstdio>
+
+namespace lqp::tests {
+
+  // the failed checks are printed and counted, main() returns
+  // exit_status() so that the test fails if any check failed
+
+  inline int failures = 0;
+
+  inline void check(bool condition, const char* message)
+  {
+    if (!condition) {
+      std::printf("FAILED: %s\n", message);
+      ++failures;
+    }
+  }
+
+  inline int exit_status()
+  {
+    return failures == 0 ? 0 : 1;
+  }
+
+}
+
+#endif // LQP_TESTS_CHECK_H
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#include <cmath>
+
+#include <lqp/AdmmSolver.h>
+#include <lqp/Problem.h>
+#include <lqp/Solution.h>
+
+#include "Check.h"
+
+namespace {
+
+  using lqp::tests::check;
+
+  void test_unbounded()
+  {
+    lqp::Problem problem;
+    auto x_0 = problem.add_variable(lqp::VariableCategory::Continuous, lqp::lower_bound(0.0));
+    auto x_1 = problem.add_variable(lqp::VariableCategory::Continuous, lqp::lower_bound(0.0));
+    auto x_2 = problem.add_variable(lqp::VariableCategory::Continuous, lqp::lower_bound(0.0));
+    auto x_3 = problem.add_variable(lqp::VariableCategory::Continuous, lqp::lower_bound(0.0));
+    problem.add_constraint(3 * x_0 - 2 * x_1 == 5.0);
+    problem.set_objective(lqp::Sense::Minimize, -1 * x_0 + 3 * x_1 - x_2 - 2 * x_3);
+
+    lqp::SolverConfig config;
+    config.verbose = false;
+
+    lqp::AdmmSolver solver;
+    auto solution = solver.solve(problem, config);
+    check(solution.status() == lqp::SolutionStatus::UnboundedSolution, "unbounded LP");
+  }
+
+  // the objective is unbounded on the constraints without the fixed variable
+  void test_infeasible()
+  {
+    lqp::Problem problem;
+    auto x_0 = problem.add_variable(lqp::VariableCategory::Continuous);
+    auto x_1 = problem.add_variable(lqp::VariableCategory::Continuous, lqp::bounds(-2.0, 0.0));
+    auto x_2 = problem.add_variable(lqp::VariableCategory::Continuous, lqp::bounds(0.0, 1.0));
+    problem.add_constraint(x_2 == 3.0);
+    problem.add_constraint(2 * x_0 + 3 * x_1 >= -2.0);
+    problem.set_objective(lqp::Sense::Minimize, -3 * x_0 - 2 * x_1);
+
+    lqp::SolverConfig config;
+    config.verbose = false;
+
+    lqp::AdmmSolver solver;
+    auto solution = solver.solve(problem, config);
+    check(solution.status() == lqp::SolutionStatus::NoFeasibleSolution, "infeasible LP");
+  }
+
+  void test_optimal()
+  {
+    lqp::Problem problem;
+    auto x = problem.add_variable(lqp::VariableCategory::Continuous, lqp::bounds(0.0, 4.0));
+    auto y = problem.add_variable(lqp::VariableCategory::Continuous, lqp::lower_bound(0.0));
+    problem.add_constraint(x + y <= 6.0);
+    problem.set_objective(lqp::Sense::Maximize, 2 * x + y);
+
+    lqp::SolverConfig config;
+    config.verbose = false;
+
+    lqp::AdmmSolver solver;
+    auto solution = solver.solve(problem, config);
+    check(solution.status() == lqp::SolutionStatus::Optimal, "optimal LP");
+    check(std::abs(problem.compute_objective_value(solution) - 10.0) < 1e-4, "optimal LP objective");
+    check(problem.is_feasible(solution, 1e-5), "optimal LP feasibility");
+  }
+
+}
+
+int main() {
+  test_unbounded();
+  test_infeasible();
+  test_optimal();
+  return lqp::tests::exit_status();
+}
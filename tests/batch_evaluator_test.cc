@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#include <cmath>
+
+#include <algorithm>
+#include <vector>
+
+#include <lqp/BatchEvaluator.h>
+#include <lqp/Problem.h>
+#include <lqp/Solution.h>
+
+#include "Check.h"
+
+namespace {
+
+  using lqp::tests::check;
+
+  bool close(double lhs, double rhs)
+  {
+    return std::abs(lhs - rhs) <= 1e-9 * std::max(1.0, std::abs(lhs));
+  }
+
+  // the columns of the compiled problem of a linear problem are its variables
+  void test_linear()
+  {
+    lqp::Problem problem;
+    auto x = problem.add_variable(lqp::VariableCategory::Continuous, lqp::bounds(0.0, 4.0), "x");
+    auto y = problem.add_variable(lqp::VariableCategory::Integer, lqp::bounds(-1.0, 3.0), "y");
+    auto z = problem.add_variable(lqp::VariableCategory::Binary, "z");
+
+    problem.add_constraint(x + 2 * y - z <= 5.0, "first");
+    problem.add_constraint(x - y >= -1.0, "second");
+    problem.set_objective(lqp::Sense::Minimize, 3 * x - y + 2 * z + 1);
+
+    auto compiled = problem.compile();
+    check(compiled.has_value(), "compiled problem");
+
+    const std::vector<std::vector<double>> candidates = {
+      { 0.0, 0.0, 0.0 },
+      { 4.0, 3.0, 1.0 },
+      { 1.0, -1.0, 0.0 },
+      { 5.0, 3.0, 1.0 },
+      { 0.5, 2.0, 1.0 },
+    };
+
+    const std::size_t candidate_count = candidates.size();
+    std::vector<double> values(3 * candidate_count);
+
+    for (std::size_t k = 0; k < candidate_count; ++k) {
+      for (std::size_t j = 0; j < 3; ++j) {
+        values[j * candidate_count + k] = candidates[k][j];
+      }
+    }
+
+    lqp::BatchEvaluator evaluator(*compiled);
+    const lqp::BatchEvaluation evaluation = evaluator.evaluate(values, candidate_count);
+
+    for (std::size_t k = 0; k < candidate_count; ++k) {
+      const lqp::Solution solution(lqp::SolutionStatus::Feasible, candidates[k]);
+      const lqp::FeasibilityReport report = problem.check_feasibility(solution);
+      const double vx = candidates[k][0];
+      const double vy = candidates[k][1];
+      const double vz = candidates[k][2];
+
+      check(close(evaluation.objectives[k], problem.compute_objective_value(solution)), "objective");
+      check(close(evaluation.activities[k], vx + 2 * vy - vz), "activity of the first constraint");
+      check(close(evaluation.activities[candidate_count + k], vx - vy), "activity of the second constraint");
+      check(close(evaluation.violations[k], std::max(report.max_bound_violation, report.max_constraint_violation)), "violation");
+    }
+  }
+
+  // the candidates give values to the variables of the problem, the
+  // auxiliary variables of the linearization are derived from them
+  void test_quadratic_constraint()
+  {
+    lqp::Problem problem;
+    auto b = problem.add_variable(lqp::VariableCategory::Binary, "b");
+    auto n = problem.add_variable(lqp::VariableCategory::Integer, lqp::bounds(-2.0, 5.0), "n");
+    auto x = problem.add_variable(lqp::VariableCategory::Continuous, lqp::bounds(0.0, 3.0), "x");
+
+    problem.add_constraint(b + n + x <= 6.0, "linear");
+    problem.add_constraint(2 * lqp::QExpr(b, x) - lqp::QExpr(n, x) + n >= -4.0, "quadratic");
+    problem.set_objective(lqp::Sense::Minimize, lqp::QExpr(x, x) - 3 * b + n);
+
+    lqp::BatchEvaluator evaluator(problem);
+    check(evaluator.loaded(), "linearized problem");
+    check(evaluator.variable_count() == 3, "variables of the problem");
+
+    const std::vector<std::vector<double>> candidates = {
+      { 0.0, 0.0, 0.0 },
+      { 1.0, 5.0, 3.0 },
+      { 1.0, -2.0, 1.5 },
+      { 0.0, 3.0, 2.5 },
+      { 1.0, 4.0, 0.25 },
+    };
+
+    const std::size_t candidate_count = candidates.size();
+    std::vector<double> values(3 * candidate_count);
+
+    for (std::size_t k = 0; k < candidate_count; ++k) {
+      for (std::size_t j = 0; j < 3; ++j) {
+        values[j * candidate_count + k] = candidates[k][j];
+      }
+    }
+
+    const lqp::BatchEvaluation evaluation = evaluator.evaluate(values, candidate_count);
+
+    std::size_t quadratic_row = 0;
+    auto compiled = problem.compile();
+
+    while (compiled->constraint_name(quadratic_row) != "quadratic") {
+      ++quadratic_row;
+    }
+
+    for (std::size_t k = 0; k < candidate_count; ++k) {
+      const lqp::Solution solution(lqp::SolutionStatus::Feasible, candidates[k]);
+      const double vb = candidates[k][0];
+      const double vn = candidates[k][1];
+      const double vx = candidates[k][2];
+
+      check(close(evaluation.objectives[k], problem.compute_objective_value(solution)), "objective");
+      check(close(evaluation.activities[quadratic_row * candidate_count + k], 2 * vb * vx - vn * vx + vn), "activity of the quadratic constraint");
+      check(close(evaluation.violations[k], problem.check_feasibility(solution).max_constraint_violation), "violation");
+    }
+  }
+
+
+  // the integer variable is expanded from its rounded lower bound
+  void test_fractional_lower_bound()
+  {
+    lqp::Problem problem;
+    auto x = problem.add_variable(lqp::VariableCategory::Integer, lqp::bounds(0.5, 3.0), "x");
+    auto y = problem.add_variable(lqp::VariableCategory::Continuous, lqp::bounds(0.0, 7.0), "y");
+
+    problem.add_constraint(lqp::QExpr(x, y) <= 100.0, "product");
+    problem.set_objective(lqp::Sense::Maximize, x + y);
+
+    lqp::BatchEvaluator evaluator(problem);
+    check(evaluator.loaded(), "linearized problem");
+
+    const std::vector<std::vector<double>> candidates = {
+      { 1.0, 5.0 },
+      { 2.0, 7.0 },
+      { 3.0, 0.5 },
+    };
+
+    const std::size_t candidate_count = candidates.size();
+    std::vector<double> values(2 * candidate_count);
+
+    for (std::size_t k = 0; k < candidate_count; ++k) {
+      for (std::size_t j = 0; j < 2; ++j) {
+        values[j * candidate_count + k] = candidates[k][j];
+      }
+    }
+
+    const lqp::BatchEvaluation evaluation = evaluator.evaluate(values, candidate_count);
+
+    std::size_t product_row = 0;
+    auto compiled = problem.compile();
+
+    while (compiled->constraint_name(product_row) != "product") {
+      ++product_row;
+    }
+
+    for (std::size_t k = 0; k < candidate_count; ++k) {
+      const lqp::Solution solution(lqp::SolutionStatus::Feasible, candidates[k]);
+      check(close(evaluation.activities[product_row * candidate_count + k], candidates[k][0] * candidates[k][1]), "activity of the product");
+      check(close(evaluation.violations[k], problem.check_feasibility(solution).max_constraint_violation), "violation with a fractional lower bound");
+    }
+  }
+
+}
+
+int main() {
+  test_linear();
+  test_quadratic_constraint();
+  test_fractional_lower_bound();
+  return lqp::tests::exit_status();
+}
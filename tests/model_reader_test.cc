@@ -0,0 +1,328 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#include <cmath>
+
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <lqp/CompiledProblem.h>
+#include <lqp/ModelReader.h>
+#include <lqp/Problem.h>
+
+#include "Check.h"
+
+namespace {
+
+  using lqp::tests::check;
+
+  // the names are not compared, the fixed format allows spaces in them
+  bool same(const std::optional<lqp::Problem>& actual, const lqp::Problem& expected)
+  {
+    if (!actual) {
+      return false;
+    }
+
+    auto lhs = actual->compile();
+    auto rhs = expected.compile();
+
+    if (!lhs || !rhs) {
+      return false;
+    }
+
+    return lhs->sense() == rhs->sense()
+        && lhs->objective_constant() == rhs->objective_constant()
+        && lhs->objective() == rhs->objective()
+        && lhs->quadratic_rows() == rhs->quadratic_rows()
+        && lhs->quadratic_columns() == rhs->quadratic_columns()
+        && lhs->quadratic_values() == rhs->quadratic_values()
+        && lhs->variable_categories() == rhs->variable_categories()
+        && lhs->variable_lower_bounds() == rhs->variable_lower_bounds()
+        && lhs->variable_upper_bounds() == rhs->variable_upper_bounds()
+        && lhs->constraint_lower_bounds() == rhs->constraint_lower_bounds()
+        && lhs->constraint_upper_bounds() == rhs->constraint_upper_bounds()
+        && lhs->row_starts() == rhs->row_starts()
+        && lhs->column_indices() == rhs->column_indices()
+        && lhs->values() == rhs->values();
+  }
+
+  // maximize x + 2 y - z + 3
+  //   6 <= x + y + 3 w <= 10
+  //   2 <= x + z <= 5
+  //   4 <= y + z <= 6
+  //   -0.5 <= 2 x + w <= 1
+  // with x in [0, 4], y integer in [0, 3], z <= -1 and w binary
+  lqp::Problem expected_linear()
+  {
+    lqp::Problem problem;
+    auto x = problem.add_variable(lqp::VariableCategory::Continuous, lqp::bounds(0.0, 4.0));
+    auto y = problem.add_variable(lqp::VariableCategory::Integer, lqp::bounds(0.0, 3.0));
+    auto z = problem.add_variable(lqp::VariableCategory::Continuous, lqp::upper_bound(-1.0));
+    problem.add_variable(lqp::VariableCategory::Binary, lqp::bounds(0.0, 1.0));
+
+    const std::vector<std::size_t> row_starts = { 0, 3, 5, 7, 9 };
+    const std::vector<std::size_t> col_indices = { 0, 1, 3, 0, 2, 1, 2, 0, 3 };
+    const std::vector<double> values = { 1.0, 1.0, 3.0, 1.0, 1.0, 1.0, 1.0, 2.0, 1.0 };
+    const std::vector<double> lower = { 6.0, 2.0, 4.0, -0.5 };
+    const std::vector<double> upper = { 10.0, 5.0, 6.0, 1.0 };
+    problem.add_rows(row_starts, col_indices, values, lower, upper);
+
+    problem.set_objective(lqp::Sense::Maximize, x + 2 * y - z + 3);
+    return problem;
+  }
+
+  // the ranges of L, G and E rows, a negative UP bound on a variable
+  // without lower bound, an integer block and a BV bound
+  constexpr std::string_view FreeMps = R"(NAME          LINEAR
+* the objective is maximized
+OBJSENSE
+    MAX
+ROWS
+ N  profit
+ L  lim1
+ G  lim2
+ E  bal
+ E  bal2
+ N  spare
+COLUMNS
+    x  profit 1  lim1 1
+    x  lim2 1  bal2 2
+    MARKER  'MARKER'  'INTORG'
+    y  profit 2  lim1 1
+    y  bal 1  spare 5
+    MARKER  'MARKER'  'INTEND'
+    z  profit -1  lim2 1
+    z  bal 1
+    w  lim1 3  bal2 1
+RHS
+    rhs  lim1 10  lim2 2
+    rhs  bal 4  profit -3
+    rhs  bal2 1
+RANGES
+    rng  lim1 4  lim2 -3
+    rng  bal 2  bal2 -1.5
+BOUNDS
+ UP bnd  x 4
+ UP bnd  y 3
+ UP bnd  z -1
+ BV bnd  w
+ENDATA
+)";
+
+  void test_free_mps()
+  {
+    check(same(lqp::parse_mps(FreeMps), expected_linear()), "free MPS");
+  }
+
+  // the fields of the fixed format start at the columns 2, 5, 15, 25, 40 and 50
+  std::string fixed_line(std::initializer_list<std::string_view> fields)
+  {
+    static constexpr std::size_t Starts[] = { 1, 4, 14, 24, 39, 49 };
+    std::string line;
+    std::size_t index = 0;
+
+    for (std::string_view field : fields) {
+      line.resize(Starts[index++], ' ');
+      line.append(field);
+    }
+
+    return line + '\n';
+  }
+
+  void test_fixed_mps()
+  {
+    std::string content = "NAME          LINEAR\nOBJSENSE    MAX\nROWS\n";
+    content += fixed_line({ "N", "profit" });
+    content += fixed_line({ "L", "lim 1" });
+    content += fixed_line({ "G", "lim 2" });
+    content += fixed_line({ "E", "bal" });
+    content += fixed_line({ "E", "bal 2" });
+    content += "COLUMNS\n";
+    content += fixed_line({ "", "x", "profit", "1.0", "lim 1", "1.0" });
+    content += fixed_line({ "", "x", "lim 2", "1.0", "bal 2", "2.0" });
+    content += fixed_line({ "", "MARKER", "'MARKER'", "", "'INTORG'" });
+    content += fixed_line({ "", "y", "profit", "2.0", "lim 1", "1.0" });
+    content += fixed_line({ "", "y", "bal", "1.0" });
+    content += fixed_line({ "", "MARKER", "'MARKER'", "", "'INTEND'" });
+    content += fixed_line({ "", "z", "profit", "-1.0", "lim 2", "1.0" });
+    content += fixed_line({ "", "z", "bal", "1.0" });
+    content += fixed_line({ "", "w", "lim 1", "3.0", "bal 2", "1.0" });
+    content += "RHS\n";
+    content += fixed_line({ "", "RHS", "lim 1", "10.0", "lim 2", "2.0" });
+    content += fixed_line({ "", "RHS", "bal", "4.0", "profit", "-3.0" });
+    content += fixed_line({ "", "RHS", "bal 2", "1.0" });
+    content += "RANGES\n";
+    content += fixed_line({ "", "RNG", "lim 1", "4.0", "lim 2", "-3.0" });
+    content += fixed_line({ "", "RNG", "bal", "2.0", "bal 2", "-1.5" });
+    content += "BOUNDS\n";
+    content += fixed_line({ "UP", "BND", "x", "4.0" });
+    content += fixed_line({ "UP", "BND", "y", "3.0" });
+    content += fixed_line({ "UP", "BND", "z", "-1.0" });
+    content += fixed_line({ "BV", "BND", "w" });
+    content += "ENDATA\n";
+
+    check(same(lqp::parse_mps(content, lqp::MpsFormat::Fixed), expected_linear()), "fixed MPS");
+  }
+
+  void test_lp()
+  {
+    constexpr std::string_view Lp = R"(\ the same problem in the LP format
+Maximize
+ profit: x + 2 y - z + 3
+Subject To
+ lim1: 6 <= x + y + 3 w <= 10
+ lim2: 2 <= x + z <= 5
+ bal: 4 <= y + z <= 6
+ bal2: -0.5 <= 2 x + w <= 1
+Bounds
+ x <= 4
+ 0 <= y <= 3
+ -inf <= z <= -1
+General
+ y
+Binary
+ w
+End
+)";
+
+    check(same(lqp::parse_lp(Lp), expected_linear()), "LP");
+  }
+
+  // minimize - x - y + 1/2 (2 x^2 + 2 x y + 2 y^2) with x + y <= 10
+  lqp::Problem expected_quadratic_objective()
+  {
+    lqp::Problem problem;
+    auto x = problem.add_variable(lqp::VariableCategory::Continuous);
+    auto y = problem.add_variable(lqp::VariableCategory::Continuous);
+    problem.add_constraint(x + y <= 10.0);
+    problem.set_objective(lqp::Sense::Minimize, -1 * x - y + lqp::QExpr(x, x) + lqp::QExpr(x, y) + lqp::QExpr(y, y));
+    return problem;
+  }
+
+  void test_quadratic_objective()
+  {
+    // QUADOBJ has the lower triangle, QMATRIX has the whole matrix
+    constexpr std::string_view QuadraticObjective = R"(NAME qp
+ROWS
+ N obj
+ L c
+COLUMNS
+ x obj -1 c 1
+ y obj -1 c 1
+RHS
+ RHS c 10
+BOUNDS
+ FR BND x
+ FR BND y
+QUADOBJ
+ x x 2
+ x y 1
+ y y 2
+ENDATA
+)";
+
+    constexpr std::string_view QuadraticMatrix = R"(NAME qp
+ROWS
+ N obj
+ L c
+COLUMNS
+ x obj -1 c 1
+ y obj -1 c 1
+RHS
+ RHS c 10
+BOUNDS
+ FR BND x
+ FR BND y
+QMATRIX
+ x x 2
+ x y 1
+ y x 1
+ y y 2
+ENDATA
+)";
+
+    constexpr std::string_view Lp = R"(minimize
+ obj: - x - y + [ 2 x^2 + 2 x * y + 2 y^2 ] / 2
+st
+ c: x + y <= 10
+bounds
+ x free
+ y free
+end
+)";
+
+    const lqp::Problem expected = expected_quadratic_objective();
+    check(same(lqp::parse_mps(QuadraticObjective), expected), "QUADOBJ");
+    check(same(lqp::parse_mps(QuadraticMatrix), expected), "QMATRIX");
+    check(same(lqp::parse_lp(Lp), expected), "quadratic objective in LP");
+  }
+
+  // the quadratic constraints are linearized when compiled, the product of
+  // an integer and a bounded variable can be
+  void test_quadratic_constraint()
+  {
+    constexpr std::string_view Lp = R"(min
+ obj: x - n
+st
+ q: [ 2 n * x ] - x >= -3
+bounds
+ 0 <= x <= 2
+ -1 <= n <= 4
+general
+ n
+end
+)";
+
+    lqp::Problem expected;
+    auto x = expected.add_variable(lqp::VariableCategory::Continuous, lqp::bounds(0.0, 2.0));
+    auto n = expected.add_variable(lqp::VariableCategory::Integer, lqp::bounds(-1.0, 4.0));
+    expected.add_constraint(2 * lqp::QExpr(n, x) - x >= -3.0);
+    expected.set_objective(lqp::Sense::Minimize, x - n);
+
+    check(same(lqp::parse_lp(Lp), expected), "quadratic constraint in LP");
+  }
+
+
+  void test_invalid_mps()
+  {
+    constexpr std::string_view WithoutName = R"(ROWS
+ N obj
+ L c
+COLUMNS
+ x obj 1 c 1
+ENDATA
+)";
+
+    constexpr std::string_view WithoutRows = R"(NAME empty
+COLUMNS
+ENDATA
+)";
+
+    constexpr std::string_view WithoutEnd = R"(NAME truncated
+ROWS
+ N obj
+ L c
+COLUMNS
+ x obj 1 c 1
+)";
+
+    check(!lqp::parse_mps(""), "empty MPS");
+    check(!lqp::parse_mps(WithoutName), "MPS without NAME");
+    check(!lqp::parse_mps(WithoutRows), "MPS without ROWS");
+    check(!lqp::parse_mps(WithoutEnd), "MPS without ENDATA");
+    check(!lqp::parse_mps(FreeMps.substr(0, FreeMps.find("BOUNDS"))), "truncated MPS");
+  }
+
+}
+
+int main() {
+  test_free_mps();
+  test_fixed_mps();
+  test_lp();
+  test_quadratic_objective();
+  test_quadratic_constraint();
+  test_invalid_mps();
+  return lqp::tests::exit_status();
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-3.0
+// Copyright (c) 2023-2024 Julien Bernard
+#include <cmath>
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include <lqp/PortfolioSolver.h>
+#include <lqp/Problem.h>
+#include <lqp/Solution.h>
+
+#include "Check.h"
+
+namespace {
+
+  using lqp::tests::check;
+
+  // the optimal solution is x = 2, y = 0, z = 1
+  void test_optimal()
+  {
+    lqp::Problem problem;
+    auto x = problem.add_variable(lqp::VariableCategory::Integer, lqp::lower_bound(0.0));
+    auto y = problem.add_variable(lqp::VariableCategory::Integer, lqp::lower_bound(0.0));
+    auto z = problem.add_variable(lqp::VariableCategory::Integer, lqp::lower_bound(0.0));
+    problem.add_constraint(2 * x + 3 * y + z <= 5.0);
+    problem.add_constraint(4 * x + y + 2 * z <= 11.0);
+    problem.add_constraint(3 * x + 4 * y + 2 * z <= 8.0);
+    problem.set_objective(lqp::Sense::Maximize, 5 * x + 4 * y + 3 * z);
+
+    lqp::SolverConfig config;
+    config.use_mip = true;
+    config.verbose = false;
+
+    lqp::PortfolioSolver solver;
+    auto solution = solver.solve(problem, config);
+    check(solution.status() == lqp::SolutionStatus::Optimal, "optimal MIP");
+    check(std::abs(problem.compute_objective_value(solution) - 13.0) < 1e-6, "optimal MIP objective");
+  }
+
+  // a market split instance (Cornuejols and Dawande), far too hard to be
+  // solved by branch and bound in the time of the test
+  lqp::Problem market_split(std::size_t row_count)
+  {
+    const std::size_t variable_count = 10 * (row_count - 1);
+    std::mt19937 engine(42);
+    std::uniform_int_distribution<int> coefficient(0, 99);
+
+    lqp::Problem problem;
+    auto variables = problem.add_variables(variable_count, lqp::VariableCategory::Binary);
+    lqp::LExpr objective;
+
+    for (std::size_t row = 0; row < row_count; ++row) {
+      lqp::LExpr expression;
+      double sum = 0.0;
+
+      for (std::size_t index = 0; index < variable_count; ++index) {
+        const double value = coefficient(engine);
+        expression.add_term(value, variables[index]);
+        sum += value;
+      }
+
+      auto surplus = problem.add_variable(lqp::VariableCategory::Continuous, lqp::lower_bound(0.0));
+      auto slack = problem.add_variable(lqp::VariableCategory::Continuous, lqp::lower_bound(0.0));
+      expression.add_term(1.0, surplus);
+      expression.add_term(-1.0, slack);
+      expression.finalize();
+      problem.add_constraint(expression == double(static_cast<long>(sum / 2)));
+
+      objective.add_term(1.0, surplus);
+      objective.add_term(1.0, slack);
+    }
+
+    objective.finalize();
+    problem.set_objective(lqp::Sense::Minimize, objective);
+    return problem;
+  }
+
+  void test_stop()
+  {
+    const lqp::Problem problem = market_split(6);
+
+    std::atomic<bool> stop = false;
+
+    lqp::SolverConfig config;
+    config.use_mip = true;
+    config.verbose = false;
+    config.stop = &stop;
+
+    std::thread canceller([&stop]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      stop = true;
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+
+    lqp::PortfolioSolver solver;
+    auto solution = solver.solve(problem, config);
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    canceller.join();
+
+    check(elapsed < std::chrono::seconds(10), "cancelled portfolio solve");
+    check(solution.status() != lqp::SolutionStatus::Optimal, "cancelled before the end");
+  }
+
+}
+
+int main() {
+  test_optimal();
+  test_stop();
+  return lqp::tests::exit_status();
+}
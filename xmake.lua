@@ -4,6 +4,8 @@ set_version("0.1.0")
 add_requires("glpk")
 
 option("examples", { description = "Build examples", default = true })
+option("benchmarks", { description = "Build benchmarks", default = false })
+option("tests", { description = "Build tests", default = false })
 
 add_rules("mode.debug", "mode.releasedbg", "mode.release")
 add_rules("plugin.compile_commands.autoupdate", {outputdir = "$(buildir)"})
@@ -32,6 +34,9 @@ target("lqp")
     add_headerfiles("include/(lqp/*.h)")
     add_includedirs("include", { public = true })
     add_packages("glpk")
+    if is_plat("linux", "bsd") then
+        add_syslinks("pthread")
+    end
     set_license("GPL-3.0")
 
 if has_config("examples") then
@@ -42,3 +47,30 @@ if has_config("examples") then
       add_deps("lqp")
 
 end
+
+if has_config("benchmarks") then
+
+    target("expr_benchmark")
+      set_kind("binary")
+      add_files("benchmarks/expr_benchmark.cc")
+      add_deps("lqp")
+
+    target("glpk_load_benchmark")
+      set_kind("binary")
+      add_files("benchmarks/glpk_load_benchmark.cc")
+      add_deps("lqp")
+
+end
+
+if has_config("tests") then
+
+    for _, file in ipairs(os.files("tests/*_test.cc")) do
+        target(path.basename(file))
+          set_kind("binary")
+          set_group("tests")
+          add_files(file)
+          add_deps("lqp")
+          add_tests("default")
+    end
+
+end